@@ -0,0 +1,65 @@
+#include<cstdio>
+#include<ctime>
+#include<cstdlib>
+#include<string>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int N = 4000000;
+const int Q = 2000000;
+const int BATCH = 64;
+
+typedef sjtu::linked_hashmap<string, int> Map;
+
+Map Q1;
+string probe[Q];
+
+string name(int i){
+	return "key-number-" + to_string(i);
+}
+
+void init(){
+	for(int i = 0; i < N; i++) Q1[name(i * 2)] = i;
+	srand(1);
+	for(int i = 0; i < Q; i++) probe[i] = name(rand() % (2 * N));
+}
+
+bool check1(){// one find() after another
+	long long sum = 0;
+	clock_t st = clock();
+	for(int i = 0; i < Q; i++){
+		Map::iterator it = Q1.find(probe[i]);
+		if(it != Q1.end()) sum += it->second;
+	}
+	printf("%-40s %10.2f ms\n", "find()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return sum > 0;
+}
+
+bool check2(){// the same keys, 64 at a time
+	long long sum = 0;
+	Map::iterator out[BATCH];
+	clock_t st = clock();
+	for(int i = 0; i < Q; i += BATCH){
+		Q1.find_batch(probe + i, BATCH, out);
+		for(int j = 0; j < BATCH; j++)
+			if(out[j] != Q1.end()) sum += out[j]->second;
+	}
+	printf("%-40s %10.2f ms\n", "find_batch()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return sum > 0;
+}
+
+bool check3(){
+	size_t hits = 0, loose = 0, out[BATCH];
+	clock_t st = clock();
+	for(int i = 0; i < Q; i += BATCH) hits += Q1.count_batch(probe + i, BATCH, out);
+	printf("%-40s %10.2f ms\n", "count_batch()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	for(int i = 0; i < Q; i++) loose += Q1.count(probe[i]);
+	return hits == loose;
+}
+
+int main(){
+	init();
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	if(!check3()) puts("check3 failed");
+	return 0;
+}
@@ -0,0 +1,59 @@
+#include<cstdio>
+#include<cstdlib>
+#include<ctime>
+#include<new>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int N = 1 << 16;
+const int ROUNDS = 1 << 20;
+
+long long allocations = 0;
+
+void *operator new(size_t size){
+	allocations++;
+	void *p = malloc(size);
+	if(p == nullptr) throw bad_alloc();
+	return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+bool check1(){// steady-state churn: erase the oldest key, insert a fresh one
+	sjtu::linked_hashmap<int, int> Q;
+	for(int i = 0; i < N; i++) Q[i] = i;
+	long long before = allocations;
+	clock_t st = clock();
+	for(int r = 0; r < ROUNDS; r++){
+		Q.erase(Q.begin());
+		Q[N + r] = r;
+	}
+	double ms = 1000.0 * (clock() - st) / CLOCKS_PER_SEC;
+	printf("%-40s %10.2f ms %8lld operator new\n", "erase begin() + insert", ms, allocations - before);
+	return Q.size() == N;
+}
+
+int keys[N];
+
+bool check2(){// iteration over a map built after heavy churn at random positions
+	sjtu::linked_hashmap<int, int> Q;
+	for(int i = 0; i < N; i++) Q[keys[i] = i] = i;
+	for(int r = 0; r < ROUNDS; r++){
+		int k = rand() % N;
+		Q.erase(Q.find(keys[k]));
+		Q[keys[k] = N + r] = r;
+	}
+	long long sum = 0;
+	clock_t st = clock();
+	for(int k = 0; k < 64; k++)
+		for(sjtu::linked_hashmap<int, int>::iterator it = Q.begin(); it != Q.end(); ++it) sum += it->second;
+	printf("%-40s %10.2f ms\n", "iterate 64 times after churn", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return sum != 0;
+}
+
+int main(){
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	return 0;
+}
@@ -0,0 +1,72 @@
+#include<cstdio>
+#include<ctime>
+#include<string>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int N = 200000;
+const int ROUNDS = 10;
+
+class Key{
+public:
+	static int counter;
+	int x;
+	Key(int x):x(x){}
+	Key(const Key &other):x(other.x){
+		counter++;
+	}
+};
+int Key::counter = 0;
+
+class Data{
+public:
+	static int counter;
+	string s;
+	Data(int p):s(64, 'a' + p % 26){}
+	Data(const Data &other):s(other.s){
+		counter++;
+	}
+};
+int Data::counter = 0;
+
+struct cmp{
+	bool operator ()(const Key &a,const Key &b)const{return a.x == b.x;}
+};
+class Hash {
+public:
+	size_t operator () (const Key &rhs) const {
+		return std::hash<int>()(rhs.x);
+	}
+};
+
+typedef sjtu::linked_hashmap<Key, Data, Hash, cmp> Map;
+
+Map Q;
+
+bool check1(){// half the probes hit, half miss
+	Key::counter = Data::counter = 0;
+	size_t hits = 0;
+	clock_t st = clock();
+	for(int r = 0; r < ROUNDS; r++)
+		for(int i = 0; i < 2 * N; i++) hits += Q.count(Key(i));
+	printf("%-40s %10.2f ms\n", "count()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	printf("%-40s %10d\n", "key copies", Key::counter);
+	printf("%-40s %10d\n", "value copies", Data::counter);
+	return hits == (size_t)ROUNDS * N && Key::counter == 0 && Data::counter == 0;
+}
+
+bool check2(){
+	Key::counter = Data::counter = 0;
+	size_t hits = 0;
+	clock_t st = clock();
+	for(int r = 0; r < ROUNDS; r++)
+		for(int i = 0; i < 2 * N; i++) hits += Q.contains(Key(i));
+	printf("%-40s %10.2f ms\n", "contains()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return hits == (size_t)ROUNDS * N && Key::counter == 0 && Data::counter == 0;
+}
+
+int main(){
+	for(int i = 0; i < N; i++) Q.try_emplace(Key(2 * i), i);
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	return 0;
+}
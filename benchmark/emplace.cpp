@@ -0,0 +1,56 @@
+#include<cstdio>
+#include<ctime>
+#include<string>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int N = 200000;
+const int LEN = 256;// long enough to live on the heap
+
+typedef sjtu::linked_hashmap<int, string> Map;
+
+bool check1(){// build the pair, then insert copies it into the node
+	Map Q;
+	clock_t st = clock();
+	for(int i = 0; i < N; i++) Q.insert(Map::value_type(i, string(LEN, 'a' + i % 26)));
+	printf("%-40s %10.2f ms\n", "insert(value_type)", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return Q.size() == N;
+}
+
+bool check2(){// default-construct in the node, then assign
+	Map Q;
+	clock_t st = clock();
+	for(int i = 0; i < N; i++) Q[i] = string(LEN, 'a' + i % 26);
+	printf("%-40s %10.2f ms\n", "operator[] then assign", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return Q.size() == N;
+}
+
+bool check3(){// the string is built directly in the node
+	Map Q;
+	clock_t st = clock();
+	for(int i = 0; i < N; i++) Q.try_emplace(i, LEN, 'a' + i % 26);
+	printf("%-40s %10.2f ms\n", "try_emplace(key, args...)", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return Q.size() == N;
+}
+
+bool check4(){// overwrite every value of an existing map
+	Map Q;
+	for(int i = 0; i < N; i++) Q.try_emplace(i);
+	clock_t st = clock();
+	for(int i = 0; i < N; i++) Q.insert_or_assign(i, string(LEN, 'a' + i % 26));
+	printf("%-40s %10.2f ms\n", "insert_or_assign on present keys", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return Q.size() == N && Q.at(N - 1).size() == LEN;
+}
+
+void warmUp(){// fault in the heap pages first, or check1 pays for them
+	Map Q;
+	for(int i = 0; i < N; i++) Q.try_emplace(i, LEN, 'a');
+}
+
+int main(){
+	warmUp();
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	if(!check3()) puts("check3 failed");
+	if(!check4()) puts("check4 failed");
+	return 0;
+}
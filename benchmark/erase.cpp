@@ -0,0 +1,81 @@
+#include<cstdio>
+#include<ctime>
+#include<vector>
+#include<algorithm>
+#include<string>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int MOD = 998244353;
+int cur = 233,base = 2333;
+inline int rand(){
+	cur = 1ll*cur*base%MOD;
+	return cur;
+}
+class Spread{
+public:
+	size_t operator () (int x) const {
+		return std::hash<int>()(x);
+	}
+};
+class Crowded{// 32 keys share every hash value, like a chain at loadFactor 32
+public:
+	size_t operator () (int x) const {
+		return std::hash<int>()(x >> 5);
+	}
+};
+const int N = 1 << 20;
+vector<int> keys;
+
+void makeKeys(){
+	keys.clear();
+	for(int i = 0; i < N / 32; i++)
+		for(int j = 0; j < 32; j++)
+			keys.push_back((int)(((1ll * i * 40503) & ((1 << 25) - 1)) << 5 | j));
+}
+
+template<class Hash>
+double eraseRandom(){// erase through iterators collected beforehand, in random order
+	sjtu::linked_hashmap<int, int, Hash> Q;
+	typedef typename sjtu::linked_hashmap<int, int, Hash>::iterator iter;
+	vector<iter> its;
+	for(int i = 0; i < N; i++) its.push_back(Q.insert(typename sjtu::linked_hashmap<int, int, Hash>::value_type(keys[i], i)).first);
+	for(int i = N - 1; i > 0; i--) swap(its[i], its[rand() % (i + 1)]);
+	clock_t st = clock();
+	for(int i = 0; i < N; i++) Q.erase(its[i]);
+	return 1000.0 * (clock() - st) / CLOCKS_PER_SEC;
+}
+
+template<class Hash>
+double eraseFront(){// drain in insertion order through begin()
+	sjtu::linked_hashmap<int, int, Hash> Q;
+	for(int i = 0; i < N; i++) Q[keys[i]] = i;
+	clock_t st = clock();
+	while(!Q.empty()) Q.erase(Q.begin());
+	return 1000.0 * (clock() - st) / CLOCKS_PER_SEC;
+}
+
+double eraseString(){// string keys, where locating the slot used to mean rehashing the key
+	sjtu::linked_hashmap<string, int> Q;
+	typedef sjtu::linked_hashmap<string, int>::iterator iter;
+	vector<iter> its;
+	char buf[64];
+	for(int i = 0; i < N; i++){
+		sprintf(buf, "session/%d/user/%d/profile", keys[i], i);
+		its.push_back(Q.insert(sjtu::linked_hashmap<string, int>::value_type(buf, i)).first);
+	}
+	for(int i = N - 1; i > 0; i--) swap(its[i], its[rand() % (i + 1)]);
+	clock_t st = clock();
+	for(int i = 0; i < N; i++) Q.erase(its[i]);
+	return 1000.0 * (clock() - st) / CLOCKS_PER_SEC;
+}
+
+int main(){
+	makeKeys();
+	for(int i = N - 1; i > 0; i--) swap(keys[i], keys[rand() % (i + 1)]);
+	printf("%-40s %10.2f ms\n", "erase random, spread hash", eraseRandom<Spread>());
+	printf("%-40s %10.2f ms\n", "erase random, 32 keys per hash", eraseRandom<Crowded>());
+	printf("%-40s %10.2f ms\n", "erase begin(), spread hash", eraseFront<Spread>());
+	printf("%-40s %10.2f ms\n", "erase begin(), 32 keys per hash", eraseFront<Crowded>());
+	printf("%-40s %10.2f ms\n", "erase random, string keys", eraseString());
+	return 0;
+}
@@ -0,0 +1,41 @@
+#include<cstdio>
+#include<ctime>
+#include<string>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int N = 200000;
+const int LEN = 128;
+
+typedef sjtu::linked_hashmap<string, string> Map;
+
+void fill(Map &Q){
+	for(int i = 0; i < N; i++) Q.try_emplace(to_string(i), LEN, 'a' + i % 26);
+}
+
+bool check1(){// copy into the other shard, then erase
+	Map A, B;
+	fill(A);
+	clock_t st = clock();
+	while(A.size() != 0){
+		Map::iterator it = A.begin();
+		B.insert(*it);
+		A.erase(it);
+	}
+	printf("%-40s %10.2f ms\n", "insert(*it) + erase(it)", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return B.size() == N;
+}
+
+bool check2(){// moves each value into a node of its own, then relinks that
+	Map A, B;
+	fill(A);
+	clock_t st = clock();
+	while(A.size() != 0) B.insert(A.extract(A.begin()));
+	printf("%-40s %10.2f ms\n", "insert(extract(it))", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return B.size() == N;
+}
+
+int main(){
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	return 0;
+}
@@ -0,0 +1,56 @@
+#include<cstdio>
+#include<ctime>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int N = 100000;
+const int Q = 12 * N;
+
+typedef sjtu::linked_hashmap<int, int> Map;
+
+Map M;
+
+bool check1(){// three misses in four throw and unwind
+	long long sum = 0;
+	clock_t st = clock();
+	for(int i = 0; i < Q; i++){
+		try{
+			sum += M.at(i % (4 * N));
+		}catch(...){}
+	}
+	printf("%-40s %10.2f ms\n", "try { at() } catch", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return sum == 3LL * N * (N - 1) / 2;
+}
+
+bool check2(){
+	long long sum = 0;
+	clock_t st = clock();
+	for(int i = 0; i < Q; i++){
+		const int *v = M.get_if(i % (4 * N));
+		if(v != nullptr) sum += *v;
+	}
+	printf("%-40s %10.2f ms\n", "get_if()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return sum == 3LL * N * (N - 1) / 2;
+}
+
+bool check3(){
+#ifdef SJTU_LINKEDHASHMAP_OPTIONAL
+	long long sum = 0;
+	clock_t st = clock();
+	for(int i = 0; i < Q; i++){
+		auto v = M.try_at(i % (4 * N));
+		if(v) sum += v->get();
+	}
+	printf("%-40s %10.2f ms\n", "try_at()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return sum == 3LL * N * (N - 1) / 2;
+#else
+	return true;
+#endif
+}
+
+int main(){
+	for(int i = 0; i < N; i++) M[i] = i;
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	if(!check3()) puts("check3 failed");
+	return 0;
+}
@@ -0,0 +1,56 @@
+#include<cstdio>
+#include<ctime>
+#include<string>
+#include<functional>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int N = 100000;
+const int SHARDS = 8;
+const int ROUNDS = 10;
+const int LEN = 256;
+
+typedef sjtu::linked_hashmap<string, int> Map;
+
+string keys[N];
+Map shard[SHARDS];
+
+void init(){
+	for(int i = 0; i < N; i++){
+		keys[i] = string(LEN, 'a' + i % 26) + to_string(i);
+		size_t h = hash<string>()(keys[i]);
+		shard[h % SHARDS][keys[i]] = i;
+	}
+}
+
+bool check1(){// the router hashes, then find() hashes again
+	long long sum = 0;
+	clock_t st = clock();
+	for(int r = 0; r < ROUNDS; r++)
+		for(int i = 0; i < N; i++){
+			size_t h = hash<string>()(keys[i]);
+			Map::iterator it = shard[h % SHARDS].find(keys[i]);
+			sum += it->second;
+		}
+	printf("%-40s %10.2f ms\n", "route + find()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return sum == (long long)ROUNDS * N * (N - 1) / 2;
+}
+
+bool check2(){// the router's hash is handed to the map
+	long long sum = 0;
+	clock_t st = clock();
+	for(int r = 0; r < ROUNDS; r++)
+		for(int i = 0; i < N; i++){
+			size_t h = hash<string>()(keys[i]);
+			Map::iterator it = shard[h % SHARDS].find_hashed(keys[i], h);
+			sum += it->second;
+		}
+	printf("%-40s %10.2f ms\n", "route + find_hashed()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return sum == (long long)ROUNDS * N * (N - 1) / 2;
+}
+
+int main(){
+	init();
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	return 0;
+}
@@ -0,0 +1,89 @@
+#include<cstdio>
+#include<cstdlib>
+#include<ctime>
+#include<new>
+#include<list>
+#include<unordered_map>
+#include<utility>
+#include "lru_cache.hpp"
+using namespace std;
+const int CAP = 1 << 16;
+const int RANGE = 1 << 18;
+const int Q = 1 << 22;
+
+long long allocations = 0;
+
+void *operator new(size_t size){
+	allocations++;
+	void *p = malloc(size);
+	if(p == nullptr) throw bad_alloc();
+	return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+int probe[Q];
+
+class HandRolled{// the usual list + map pair
+	typedef list<pair<int, long long> > List;
+	List order;
+	unordered_map<int, List::iterator> index;
+public:
+	HandRolled(){
+		index.reserve(CAP);
+	}
+	long long *get(int key){
+		unordered_map<int, List::iterator>::iterator it = index.find(key);
+		if(it == index.end()) return nullptr;
+		order.splice(order.end(), order, it->second);
+		return &it->second->second;
+	}
+	void put(int key, long long value){
+		if((int)order.size() == CAP){
+			index.erase(order.front().first);
+			order.pop_front();
+		}
+		order.push_back(make_pair(key, value));
+		index[key] = --order.end();
+	}
+};
+
+bool check1(){
+	HandRolled cache;
+	long long sum = 0, before = allocations;
+	clock_t st = clock();
+	for(int i = 0; i < Q; i++){
+		long long *v = cache.get(probe[i]);
+		if(v != nullptr) sum += *v;
+		else cache.put(probe[i], probe[i]);
+	}
+	double ms = 1000.0 * (clock() - st) / CLOCKS_PER_SEC;
+	printf("%-40s %10.2f ms %8lld operator new\n", "std::list + std::unordered_map", ms, allocations - before);
+	return sum > 0;
+}
+
+bool check2(){
+	sjtu::lru_cache<int, long long> cache(CAP);
+	long long sum = 0, before = allocations;
+	clock_t st = clock();
+	for(int i = 0; i < Q; i++){
+		long long *v = cache.get(probe[i]);
+		if(v != nullptr) sum += *v;
+		else cache.put(probe[i], probe[i]);
+	}
+	double ms = 1000.0 * (clock() - st) / CLOCKS_PER_SEC;
+	printf("%-40s %10.2f ms %8lld operator new\n", "sjtu::lru_cache", ms, allocations - before);
+	printf("%-40s %10zu hits %7zu evictions\n", "", cache.hits(), cache.evictions());
+	return sum > 0 && cache.hits() + cache.misses() == Q;
+}
+
+int main(){
+	srand(1);
+	for(int i = 0; i < Q; i++)// mostly a hot eighth of the keys, a cold key now and then
+		probe[i] = rand() % RANGE * (rand() % 4 == 0) + rand() % (RANGE / 8);
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	return 0;
+}
@@ -0,0 +1,57 @@
+#include<cstdio>
+#include<ctime>
+#include<string>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int N = 200000;
+const int SHARDS = 8;
+const int LEN = 128;
+
+typedef sjtu::linked_hashmap<string, string> Map;
+
+void fill(Map *S){
+	for(int i = 0; i < N; i++) S[i % SHARDS].try_emplace(to_string(i), LEN, 'a' + i % 26);
+}
+
+bool check1(){// fold the shards by copying every element
+	Map S[SHARDS], G;
+	fill(S);
+	G.reserve(N);
+	clock_t st = clock();
+	for(int s = 0; s < SHARDS; s++){
+		for(Map::iterator it = S[s].begin(); it != S[s].end(); ++it) G.insert(*it);
+		S[s].clear();
+	}
+	printf("%-40s %10.2f ms\n", "insert(*it) + clear()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return G.size() == N;
+}
+
+bool check2(){// fold the shards by relinking their nodes
+	Map S[SHARDS], G;
+	fill(S);
+	G.reserve(N);
+	clock_t st = clock();
+	for(int s = 0; s < SHARDS; s++) G.merge(S[s]);
+	printf("%-40s %10.2f ms\n", "merge()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return G.size() == N && S[0].size() == 0;
+}
+
+bool check3(){// rotate the oldest half behind the newest one
+	Map Q;
+	for(int i = 0; i < N; i++) Q.try_emplace(to_string(i), LEN, 'a' + i % 26);
+	clock_t st = clock();
+	for(int r = 0; r < 100; r++){
+		Map::iterator mid = Q.begin();
+		for(int i = 0; i < N / 2; i++) ++mid;
+		Q.splice(Q.end(), Q, Q.begin(), mid);
+	}
+	printf("%-40s %10.2f ms\n", "splice() within the map, x100", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return Q.size() == N && Q.begin()->first == "0";
+}
+
+int main(){
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	if(!check3()) puts("check3 failed");
+	return 0;
+}
@@ -0,0 +1,44 @@
+#include<cstdio>
+#include<ctime>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int N = 1 << 16 | 1;// one past a growth threshold of the default policy
+const int ROUNDS = 2000;// the old shrink rule rebuilt the table twice per round here
+
+double oscillate(sjtu::linked_hashmap<int, int> &Q){// hover around N: drop two keys, add two back
+	for(int i = 0; i < N; i++) Q[i] = i;
+	int next = N;
+	clock_t st = clock();
+	for(int r = 0; r < ROUNDS; r++){
+		Q.erase(Q.find(next - 1));
+		Q.erase(Q.find(next - 2));
+		Q[next - 2] = r;
+		Q[next - 1] = r;
+	}
+	return 1000.0 * (clock() - st) / CLOCKS_PER_SEC;
+}
+
+bool check1(){// default policy
+	sjtu::linked_hashmap<int, int> Q;
+	printf("%-40s %10.2f ms\n", "default policy", oscillate(Q));
+	return Q.size() == N;
+}
+
+bool check2(){// table pinned at its grown size
+	sjtu::linked_hashmap<int, int> Q(sjtu::resize_policy(0.5f, 0.125f, 1 << 18));
+	printf("%-40s %10.2f ms\n", "min_buckets 1 << 18", oscillate(Q));
+	return Q.size() == N;
+}
+
+bool check3(){// shrinking disabled
+	sjtu::linked_hashmap<int, int> Q(sjtu::resize_policy(0.5f, 0.125f, 16, false));
+	printf("%-40s %10.2f ms\n", "shrink disabled", oscillate(Q));
+	return Q.size() == N;
+}
+
+int main(){
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	if(!check3()) puts("check3 failed");
+	return 0;
+}
@@ -0,0 +1,51 @@
+#include<cstdio>
+#include<ctime>
+#include<memory_resource>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int N = 1 << 20;
+const int ROUNDS = 8;
+
+template<class Map>
+double fillAndDrop(Map *Q){// time only the destruction
+	for(int i = 0; i < N; i++) (*Q)[i] = i;
+	clock_t st = clock();
+	delete Q;
+	return 1000.0 * (clock() - st) / CLOCKS_PER_SEC;
+}
+
+bool check1(){// global heap
+	double ms = 0;
+	for(int r = 0; r < ROUNDS; r++) ms += fillAndDrop(new sjtu::linked_hashmap<int, int>);
+	printf("%-40s %10.2f ms\n", "std::allocator teardown", ms / ROUNDS);
+	return true;
+}
+
+bool check2(){// monotonic scratch resource, released all at once afterwards
+	double ms = 0;
+	for(int r = 0; r < ROUNDS; r++){
+		pmr::monotonic_buffer_resource scratch;
+		ms += fillAndDrop(new sjtu::pmr::linked_hashmap<int, int>(&scratch));
+	}
+	printf("%-40s %10.2f ms\n", "monotonic_buffer_resource teardown", ms / ROUNDS);
+	return true;
+}
+
+bool check3(){// the allocator reaches every node
+	char buffer[1 << 16];
+	pmr::monotonic_buffer_resource scratch(buffer, sizeof(buffer), pmr::null_memory_resource());
+	sjtu::pmr::linked_hashmap<int, int> Q(&scratch);
+	for(int i = 0; i < 200; i++) Q[i] = i;
+	for(int i = 0; i < 200; i += 2) Q.erase(Q.find(i));
+	for(int i = 0; i < 200; i += 2) Q[i] = -i;
+	long long sum = 0;
+	for(sjtu::pmr::linked_hashmap<int, int>::iterator it = Q.begin(); it != Q.end(); ++it) sum += it->second;
+	return Q.get_allocator().resource() == &scratch && Q.size() == 200 && sum == 100;
+}
+
+int main(){
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	if(!check3()) puts("check3 failed");
+	return 0;
+}
@@ -0,0 +1,60 @@
+#include<cstdio>
+#include<ctime>
+#include<cstdlib>
+#include<string>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int N = 100000;
+const int Q = 2000000;
+
+typedef sjtu::linked_hashmap<string, string> Map;
+
+string keys[N];
+int probe[Q];
+
+void fill(Map &M){
+	for(int i = 0; i < N; i++) M[keys[i]] = string(64, 'a' + i % 26);
+}
+
+bool check1(){// promote a hit by erasing and reinserting it
+	Map M;
+	fill(M);
+	clock_t st = clock();
+	for(int i = 0; i < Q; i++){
+		Map::iterator it = M.find(keys[probe[i]]);
+		sjtu::pair<const string, string> kept = *it;
+		M.erase(it);
+		M.insert(kept);
+	}
+	printf("%-40s %10.2f ms\n", "erase() + insert()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return M.size() == N && (--M.end())->first == keys[probe[Q - 1]];
+}
+
+bool check2(){// relink the node
+	Map M;
+	fill(M);
+	clock_t st = clock();
+	for(int i = 0; i < Q; i++) M.move_to_back(M.find(keys[probe[i]]));
+	printf("%-40s %10.2f ms\n", "move_to_back()", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return M.size() == N && (--M.end())->first == keys[probe[Q - 1]];
+}
+
+bool check3(){// let find() do it
+	Map M;
+	fill(M);
+	M.set_access_order(true);
+	clock_t st = clock();
+	for(int i = 0; i < Q; i++) M.find(keys[probe[i]]);
+	printf("%-40s %10.2f ms\n", "find() in access order", 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return M.size() == N && (--M.end())->first == keys[probe[Q - 1]];
+}
+
+int main(){
+	for(int i = 0; i < N; i++) keys[i] = "session-" + to_string(i);
+	srand(1);
+	for(int i = 0; i < Q; i++) probe[i] = rand() % N;
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	if(!check3()) puts("check3 failed");
+	return 0;
+}
@@ -0,0 +1,47 @@
+#include<cstdio>
+#include<ctime>
+#include "linked_hashmap.hpp"
+using namespace std;
+const int N = 20000;
+const int ROUNDS = 10;
+
+struct MaskHash{// identity hash, low bits only: what the table did before hash mixing
+	typedef sjtu::power_of_two_hash_policy hash_policy;
+	size_t operator()(int x) const { return x; }
+};
+
+struct PrimeHash{
+	typedef sjtu::prime_hash_policy hash_policy;
+	size_t operator()(int x) const { return x; }
+};
+
+template<class Hash>
+bool stride(const char *name, int step){// keys i * step share their low bits once step is a power of 2
+	sjtu::linked_hashmap<int, int, Hash> Q;
+	clock_t st = clock();
+	for(int i = 0; i < N; i++) Q[i * step] = i;
+	long long sum = 0;
+	for(int r = 0; r < ROUNDS; r++)
+		for(int i = 0; i < N; i++) sum += Q.find(i * step)->second;
+	printf("%-24s stride %-6d %10.2f ms\n", name, step, 1000.0 * (clock() - st) / CLOCKS_PER_SEC);
+	return sum == (long long)ROUNDS * N * (N - 1) / 2;
+}
+
+bool check1(){// default fibonacci policy
+	return stride<std::hash<int> >("fibonacci", 1) && stride<std::hash<int> >("fibonacci", 16) && stride<std::hash<int> >("fibonacci", 1024);
+}
+
+bool check2(){// plain mask
+	return stride<MaskHash>("power of two", 1) && stride<MaskHash>("power of two", 16) && stride<MaskHash>("power of two", 1024);
+}
+
+bool check3(){// prime modulo
+	return stride<PrimeHash>("prime", 1) && stride<PrimeHash>("prime", 16) && stride<PrimeHash>("prime", 1024);
+}
+
+int main(){
+	if(!check1()) puts("check1 failed");
+	if(!check2()) puts("check2 failed");
+	if(!check3()) puts("check3 failed");
+	return 0;
+}
@@ -0,0 +1,100 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <string>
+#include <cassert>
+class Integer {
+public:
+	static int counter;
+	int val;
+
+	Integer(int val) : val(val) {
+		counter++;
+	}
+
+	Integer(const Integer &rhs) {
+		val = rhs.val;
+		counter++;
+	}
+
+	Integer& operator = (const Integer &rhs) {
+		assert(false);
+	}
+
+	~Integer() {
+		counter--;
+	}
+};
+
+int Integer::counter = 0;
+
+class Equal {
+public:
+	typedef void is_transparent;
+	bool operator () (const Integer &lhs, const Integer &rhs) const {
+		return lhs.val == rhs.val;
+	}
+	bool operator () (int lhs, const Integer &rhs) const {
+		return lhs == rhs.val;
+	}
+};
+class Hash {
+public:
+	typedef void is_transparent;
+	size_t operator () (const Integer &lhs) const {
+		return std::hash<int>()(lhs.val);
+	}
+	size_t operator () (int lhs) const {
+		return std::hash<int>()(lhs);
+	}
+};
+class PlainHash {
+public:
+	size_t operator () (const Integer &lhs) const {
+		return std::hash<int>()(lhs.val);
+	}
+};
+typedef sjtu::linked_hashmap<Integer, std::string, Hash, Equal> Map;
+
+void tester(void) {
+	Map map;
+	for (int i = 0; i < 1000; i++) map[Integer(i)] = std::to_string(i);
+	int before = Integer::counter;
+
+	long long hits = 0;
+	for (int i = -500; i < 1500; i++) {
+		hits += map.count(i);
+		hits += map.contains(i);
+		if (map.find(i) != map.end()) hits += map.find(i)->first.val == i;
+	}
+	const Map &cmap = map;
+	std::cout << hits << " " << (cmap.find(1000) == cmap.cend()) << " " << cmap.at(7) << " " << map.at(8) << "\n";
+	map.at(9) += "!";
+	std::cout << map.at(Integer(9)) << "\n";
+	try {
+		map.at(-1);
+		std::cout << "no throw\n";
+	} catch (...) {
+		std::cout << "throw\n";
+	}
+	std::cout << (Integer::counter == before) << "\n";
+
+	size_t erased = 0;
+	for (int i = 0; i < 1000; i += 2) erased += map.erase(i);
+	erased += map.erase(0) + map.erase(5000);
+	std::cout << erased << " " << map.size() << " " << map.contains(1) << " " << map.contains(2) << "\n";
+	std::cout << (Integer::counter == before - 500) << "\n";
+
+	std::cout << map.erase(Integer(1)) << " " << map.size() << " " << map.begin()->first.val << "\n";
+	map.erase(map.begin());
+	std::cout << map.size() << " " << map.begin()->first.val << "\n";
+
+	sjtu::linked_hashmap<Integer, int, PlainHash, Equal> plain;
+	plain[Integer(3)] = 3;
+	std::cout << plain.count(3) << " " << plain.contains(Integer(4)) << "\n";
+}
+
+int main() {
+	tester();
+	std::cout << Integer::counter << "\n";
+	return 0;
+}
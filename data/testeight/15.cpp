@@ -0,0 +1,66 @@
+#include "lru_cache.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+typedef sjtu::lru_cache<int, std::string> Cache;
+
+void dump(const Cache &cache) {
+	for (Cache::const_iterator it = cache.begin(); it != cache.end(); ++it) std::cout << it->first << "=" << it->second << " ";
+	std::cout << "\n";
+}
+
+void tester(void) {
+	Cache cache(3);
+	std::vector<int> evicted;
+	cache.set_eviction_callback([&](const int &key, std::string &value) {
+		evicted.push_back(key);
+		value.clear();
+	});
+
+	cache.put(1, "one");
+	cache.put(2, "two");
+	cache.put(3, "three");
+	dump(cache);
+
+	std::cout << *cache.get(1) << " " << (cache.get(4) == nullptr) << "\n";
+	dump(cache);
+
+	cache.put(4, "four");
+	dump(cache);
+	std::cout << cache.contains(2) << " " << *cache.peek(3) << "\n";
+	dump(cache);
+
+	cache.put(3, std::string("THREE"));
+	cache.put(5, "five");
+	cache.put(6, "six");
+	dump(cache);
+	for (size_t i = 0; i < evicted.size(); i++) std::cout << evicted[i] << " ";
+	std::cout << "\n";
+
+	std::cout << cache.hits() << " " << cache.misses() << " " << cache.evictions() << " " << cache.size() << " " << cache.capacity() << "\n";
+	std::cout << cache.erase(5) << " " << cache.erase(5) << " " << cache.size() << "\n";
+	cache.put(7, "seven");
+	cache.put(8, "eight");
+	dump(cache);
+	cache.reset_stats();
+	cache.clear();
+	std::cout << cache.empty() << " " << cache.evictions() << "\n";
+	for (int i = 0; i < 100; i++) {
+		if (cache.get(i % 7) == nullptr) cache.put(i % 7, std::to_string(i));
+	}
+	dump(cache);
+	std::cout << cache.hits() << " " << cache.misses() << " " << cache.evictions() << "\n";
+
+	try {
+		Cache empty(0);
+		std::cout << "no throw\n";
+	} catch (...) {
+		std::cout << "throw\n";
+	}
+}
+
+int main() {
+	tester();
+	return 0;
+}
@@ -0,0 +1,78 @@
+#include "lru_cache.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+typedef sjtu::lru_cache<int, std::string> Cache;
+
+void dump(const Cache &cache) {
+	for (Cache::const_iterator it = cache.begin(); it != cache.end(); ++it) std::cout << it->first << ":" << it->second.size() << " ";
+	std::cout << "| " << cache.size() << " " << cache.weight() << "\n";
+}
+
+void tester(void) {
+	Cache cache(1000);
+	std::vector<int> evicted;
+	cache.set_eviction_callback([&](const int &key, std::string &) {
+		evicted.push_back(key);
+	});
+	for (int i = 0; i < 5; i++) cache.put(i, std::string(10 * (i + 1), 'x'));
+	dump(cache);
+
+	cache.set_weigher([](const int &, const std::string &value) {
+		return value.size();
+	}, 100);
+	dump(cache);
+
+	cache.put(2, std::string(5, 'y'));
+	dump(cache);
+	cache.get(4);
+	cache.put(5, std::string(40, 'z'));
+	dump(cache);
+
+	std::cout << cache.erase(4) << " " << cache.erase(4) << "\n";
+	dump(cache);
+
+	cache.put(6, std::string(500, 'w'));
+	dump(cache);
+	cache.put(7, std::string(1, 'v'));
+	dump(cache);
+
+	for (size_t i = 0; i < evicted.size(); i++) std::cout << evicted[i] << " ";
+	std::cout << "| " << cache.evictions() << " " << cache.budget() << "\n";
+
+	cache.clear();
+	dump(cache);
+	for (int i = 0; i < 1000; i++) {
+		cache.put(i % 37, std::string(i % 23, 'a'));
+		if (cache.weight() > cache.budget() && cache.size() > 1) std::cout << "over budget\n";
+	}
+	size_t total = 0;
+	for (Cache::const_iterator it = cache.begin(); it != cache.end(); ++it) total += it->second.size();
+	std::cout << (total == cache.weight()) << " " << (cache.weight() <= cache.budget()) << "\n";
+
+	//a value resized through get() keeps the weight it was charged until put() again
+	cache.clear();
+	evicted.clear();
+	cache.put(1, std::string(10, 'a'));
+	cache.put(2, std::string(20, 'b'));
+	cache.get(1)->append(50, 'a');
+	std::cout << cache.weight() << " ";
+	cache.erase(1);
+	std::cout << cache.weight() << "\n";
+	cache.get(2)->append(90, 'b');
+	cache.put(3, std::string(70, 'c'));
+	dump(cache);
+	cache.put(2, std::string(*cache.peek(2)));
+	dump(cache);
+	cache.put(4, std::string(1, 'd'));
+	dump(cache);
+	std::cout << (*cache.begin()).first << " " << evicted.size() << " " << evicted[0] << " " << evicted[1] << "\n";
+	cache.erase(4);
+	dump(cache);
+}
+
+int main() {
+	tester();
+	return 0;
+}
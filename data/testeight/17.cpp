@@ -0,0 +1,194 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <string>
+#include <cstddef>
+#include <new>
+
+class Integer {
+public:
+	static int counter;
+	int val;
+
+	Integer(int val) : val(val) {
+		counter++;
+	}
+
+	Integer(const Integer &rhs) {
+		val = rhs.val;
+		counter++;
+	}
+
+	Integer& operator = (const Integer &rhs) {
+		val = rhs.val;
+		return *this;
+	}
+
+	~Integer() {
+		counter--;
+	}
+};
+
+int Integer::counter = 0;
+
+class Hash {
+public:
+	size_t operator () (const Integer &rhs) const {
+		return rhs.val;
+	}
+};
+
+class Equal {
+public:
+	bool operator () (const Integer &lhs, const Integer &rhs) const {
+		return lhs.val == rhs.val;
+	}
+};
+
+size_t liveBytes = 0;
+
+template<class T>
+class Counting {
+public:
+	typedef T value_type;
+
+	Counting() {}
+
+	template<class U>
+	Counting(const Counting<U> &) {}
+
+	T *allocate(size_t n) {
+		liveBytes += n * sizeof(T);
+		return static_cast<T *>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T *p, size_t n) {
+		liveBytes -= n * sizeof(T);
+		::operator delete(p);
+	}
+
+	template<class U>
+	bool operator == (const Counting<U> &) const {
+		return true;
+	}
+
+	template<class U>
+	bool operator != (const Counting<U> &) const {
+		return false;
+	}
+};
+
+typedef sjtu::linked_hashmap<Integer, std::string, Hash, Equal, Counting<sjtu::pair<const Integer, std::string> > > Map;
+
+template<class T>
+class Tagged : public std::allocator<T> {
+public:
+	typedef T value_type;
+	int tag;
+
+	Tagged(int tag = 0) : tag(tag) {}
+
+	template<class U>
+	Tagged(const Tagged<U> &rhs) : tag(rhs.tag) {}
+
+	template<class U>
+	struct rebind {
+		typedef Tagged<U> other;
+	};
+
+	template<class U>
+	bool operator == (const Tagged<U> &rhs) const {
+		return tag == rhs.tag;
+	}
+
+	template<class U>
+	bool operator != (const Tagged<U> &rhs) const {
+		return tag != rhs.tag;
+	}
+};
+
+typedef sjtu::linked_hashmap<Integer, std::string, Hash, Equal, Tagged<sjtu::pair<const Integer, std::string> > > TaggedMap;
+
+void dump(const Map &map) {
+	for (Map::const_iterator it = map.cbegin(); it != map.cend(); ++it) std::cout << it->first.val << "=" << it->second << " ";
+	std::cout << "\n";
+}
+
+void tester1(void) {
+	Map a, b;
+	for (int i = 0; i < 6; i++) a[Integer(i)] = std::to_string(i * 11);
+	b[Integer(3)] = "b3";
+	b[Integer(7)] = "b7";
+
+	Map::node_type nh = a.extract(Integer(2));
+	std::cout << nh.key().val << " " << nh.mapped() << " " << a.size() << " " << a.count(Integer(2)) << "\n";
+	Map::insert_return_type res = b.insert(std::move(nh));
+	std::cout << res.inserted << " " << res.position->first.val << " " << nh.empty() << "\n";
+
+	res = b.insert(a.extract(a.find(Integer(3))));
+	std::cout << res.inserted << " " << res.position->second << " " << res.node.key().val << " " << res.node.mapped() << "\n";
+	res.node.key().val = 9;
+	res = a.insert(std::move(res.node));
+	std::cout << res.inserted << " " << a.find(Integer(9))->second << "\n";
+	std::cout << a.extract(Integer(42)).empty() << "\n";
+	dump(a);
+	dump(b);
+
+	//a node that came in through a handle can leave again, and be erased
+	nh = b.extract(Integer(2));
+	a.insert(std::move(nh));
+	a.erase(a.find(Integer(9)));
+	b.insert(a.extract(Integer(2)));
+	dump(a);
+	dump(b);
+
+	Map c(b);
+	c.clear();
+	std::cout << Integer::counter << "\n";
+}
+
+void tester2(void) {
+	Map::node_type nh;
+	size_t emptyBytes;
+	{
+		Map a;
+		emptyBytes = liveBytes;
+		for (int i = 0; i < 100000; i++) a[Integer(i)] = "";
+		a.erase(Integer(1));
+		nh = a.extract(Integer(12345));
+	}
+	//only the element's own node outlives its map
+	std::cout << (liveBytes - emptyBytes < 256) << " " << Integer::counter << " " << nh.key().val << "\n";
+
+	Map b;
+	b[Integer(1)] = "one";
+	b.insert(std::move(nh));
+	dump(b);
+	nh = b.extract(b.begin());
+	b.clear();
+	std::cout << nh.key().val << " " << nh.mapped() << " " << Integer::counter << "\n";
+	nh = Map::node_type();
+	std::cout << Integer::counter << "\n";
+}
+
+void tester3(void) {
+	//a handle only goes into a map whose allocator compares equal
+	TaggedMap a(Tagged<sjtu::pair<const Integer, std::string> >(1)), b(Tagged<sjtu::pair<const Integer, std::string> >(2));
+	a[Integer(1)] = "one";
+	b[Integer(2)] = "two";
+	TaggedMap::node_type nh = a.extract(Integer(1));
+	try {
+		b.insert(std::move(nh));
+		std::cout << "no throw\n";
+	} catch (sjtu::runtime_error &) {
+		std::cout << "runtime_error " << nh.empty() << " " << b.size() << "\n";
+	}
+	std::cout << a.insert(std::move(nh)).inserted << " " << a.find(Integer(1))->second << "\n";
+}
+
+int main() {
+	tester1();
+	tester2();
+	tester3();
+	std::cout << Integer::counter << " " << liveBytes << "\n";
+	return 0;
+}
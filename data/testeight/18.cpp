@@ -0,0 +1,123 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <string>
+
+class Integer {
+public:
+	static int counter;
+	int val;
+
+	Integer(int val) : val(val) {
+		counter++;
+	}
+
+	Integer(const Integer &rhs) {
+		val = rhs.val;
+		counter++;
+	}
+
+	Integer& operator = (const Integer &rhs) {
+		val = rhs.val;
+		return *this;
+	}
+
+	~Integer() {
+		counter--;
+	}
+};
+
+int Integer::counter = 0;
+
+class Hash {
+public:
+	size_t operator () (const Integer &rhs) const {
+		return rhs.val % 4; //plenty of equal hashes
+	}
+};
+
+class Equal {
+public:
+	bool operator () (const Integer &lhs, const Integer &rhs) const {
+		return lhs.val == rhs.val;
+	}
+};
+
+typedef sjtu::linked_hashmap<Integer, std::string, Hash, Equal> Map;
+
+void dump(const Map &map) {
+	for (Map::const_iterator it = map.cbegin(); it != map.cend(); ++it) std::cout << it->first.val << "=" << it->second << " ";
+	std::cout << "(" << map.size() << ")\n";
+}
+
+Map::iterator at(Map &map, int val) {
+	return map.find(Integer(val));
+}
+
+void tester1(void) {
+	Map a, b;
+	for (int i = 0; i < 8; i++) a[Integer(i)] = "a" + std::to_string(i);
+	for (int i = 6; i < 14; i += 2) b[Integer(i)] = "b" + std::to_string(i);
+	dump(a);
+	dump(b);
+
+	//6 and 8 collide and stay in b, the rest go to the end of a in b's order
+	a.merge(b);
+	dump(a);
+	dump(b);
+	a.merge(b);
+	dump(b);
+	b.merge(a);
+	dump(a);
+	dump(b);
+	a.merge(std::move(b));
+	dump(a);
+	dump(b);
+	a.merge(a);
+	dump(a);
+}
+
+void tester2(void) {
+	Map a, b;
+	for (int i = 0; i < 6; i++) a[Integer(i)] = "a" + std::to_string(i);
+	for (int i = 3; i < 9; i++) b[Integer(i)] = "b" + std::to_string(i);
+
+	std::cout << a.splice(at(a, 2), b, at(b, 4), at(b, 8)) << "\n";
+	dump(a);
+	dump(b);
+	std::cout << a.splice(a.end(), b, b.begin(), b.end()) << "\n";
+	dump(a);
+	dump(b);
+	std::cout << b.splice(b.end(), a, at(a, 6), at(a, 2)) << "\n";
+	dump(a);
+	dump(b);
+	std::cout << a.splice(a.begin(), b, b.begin(), b.begin()) << "\n";
+	try {
+		a.splice(b.begin(), b, b.begin(), b.end());
+	} catch (...) {
+		std::cout << "throw\n";
+	}
+}
+
+void tester3(void) {
+	//within one map only the order changes
+	Map a;
+	for (int i = 0; i < 8; i++) a[Integer(i)] = std::to_string(i);
+	std::cout << a.splice(a.begin(), a, at(a, 5), a.end()) << "\n";
+	dump(a);
+	std::cout << a.splice(a.end(), a, a.begin(), at(a, 7)) << "\n";
+	dump(a);
+	std::cout << a.splice(at(a, 3), a, at(a, 3), at(a, 5)) << "\n";
+	dump(a);
+	std::cout << a.splice(at(a, 1), a, at(a, 5), at(a, 6)) << "\n";
+	dump(a);
+	for (int i = 0; i < 8; i++) std::cout << a.at(Integer(i)) << " ";
+	std::cout << "\n";
+}
+
+int main() {
+	tester1();
+	tester2();
+	tester3();
+	std::cout << Integer::counter << "\n";
+	return 0;
+}
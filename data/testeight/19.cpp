@@ -0,0 +1,83 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <map>
+
+typedef sjtu::linked_hashmap<int, int> Map;
+
+unsigned long long seed = 19260817;
+
+int next(int range) {
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (int)((seed >> 33) % range);
+}
+
+bool same(const Map &map, const std::map<int, int> &ref) {
+	if (map.size() != ref.size())
+		return false;
+	for (std::map<int, int>::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+		Map::const_iterator pos = map.find(it->first);
+		if (pos == map.cend() || pos->second != it->second)
+			return false;
+	}
+	size_t visited = 0;
+	for (Map::const_iterator it = map.cbegin(); it != map.cend(); ++it)
+		visited++;
+	return visited == ref.size();
+}
+
+//keys come from [0, range); insertions win with probability insert / 100
+bool run(Map &map, std::map<int, int> &ref, int ops, int range, int insert) {
+	for (int i = 0; i < ops; i++) {
+		int key = next(range);
+		if (next(100) < insert) {
+			map[key] = i;
+			ref[key] = i;
+		} else {
+			std::map<int, int>::iterator it = ref.find(key);
+			Map::iterator pos = map.find(key);
+			if ((it == ref.end()) != (pos == map.end()))
+				return false;
+			if (it != ref.end()) {
+				ref.erase(it);
+				if (next(2) == 0)
+					map.erase(pos);
+				else
+					map.erase(key);
+			}
+		}
+		if (map.load_factor() > map.max_load_factor())
+			return false;
+	}
+	return same(map, ref);
+}
+
+void tester(size_t step) {
+	Map map;
+	std::map<int, int> ref;
+	map.set_incremental_rehash(step);
+	bool ok = run(map, ref, 200000, 50000, 80);
+	size_t grown = map.bucket_count();
+	ok = ok && run(map, ref, 400000, 50000, 5);
+	size_t drained = map.bucket_count();
+	ok = ok && run(map, ref, 100000, 3000, 50);
+
+	//the shrink must keep up with a wholesale erase, rehash in progress or not
+	while (!ref.empty()) {
+		map.erase(ref.begin()->first);
+		ref.erase(ref.begin());
+		if (ref.size() > 64 && map.bucket_count() > ref.size() * 16)
+			ok = false;
+	}
+	std::cout << "step " << step << ": " << (ok && same(map, ref) ? "ok" : "FAILED") << " "
+	          << grown << " " << drained << " " << map.bucket_count() << "\n";
+
+	map[1] = 1;
+	std::cout << map.size() << " " << map.at(1) << "\n";
+}
+
+int main() {
+	size_t steps[] = {0, 1, 2, 3, 16};
+	for (int i = 0; i < 5; i++)
+		tester(steps[i]);
+	return 0;
+}
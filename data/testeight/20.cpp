@@ -0,0 +1,140 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <new>
+#include <stdexcept>
+
+//throws on the failAt-th allocation, counting from when failAt was set
+int failAt = 0, calls = 0;
+size_t liveBytes = 0;
+
+template<class T>
+class Failing {
+public:
+	typedef T value_type;
+
+	Failing() {}
+
+	template<class U>
+	Failing(const Failing<U> &) {}
+
+	T *allocate(size_t n) {
+		if (++calls == failAt)
+			throw std::bad_alloc();
+		liveBytes += n * sizeof(T);
+		return static_cast<T *>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T *p, size_t n) {
+		liveBytes -= n * sizeof(T);
+		::operator delete(p);
+	}
+
+	template<class U>
+	bool operator == (const Failing<U> &) const {
+		return true;
+	}
+
+	template<class U>
+	bool operator != (const Failing<U> &) const {
+		return false;
+	}
+};
+
+typedef sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, Failing<sjtu::pair<const int, int> > > Map;
+
+class Boom {
+public:
+	int val;
+
+	Boom(int val) : val(val) {
+		if (val < 0)
+			throw std::runtime_error("boom");
+	}
+};
+
+typedef sjtu::linked_hashmap<int, Boom, std::hash<int>, std::equal_to<int>, Failing<sjtu::pair<const int, Boom> > > BoomMap;
+
+void arm(int at) {
+	calls = 0;
+	failAt = at;
+}
+
+//every element listed can be found, and the map takes new ones afterwards
+bool intact(Map &map) {
+	size_t n = 0;
+	for (Map::iterator it = map.begin(); it != map.end(); ++it, n++)
+		if (map.find(it->first) != it)
+			return false;
+	if (n != map.size())
+		return false;
+	for (int i = 0; i < 300; i++)
+		map[i] = i;
+	for (int i = 0; i < 300; i++)
+		if (map.at(i) != i)
+			return false;
+	return true;
+}
+
+void tester(size_t step) {
+	int thrown = 0, broken = 0;
+	for (int at = 1; at < 40; at++) {
+		Map map;
+		map.set_incremental_rehash(step);
+		arm(at);
+		try {
+			for (int i = 0; i < 100; i++)
+				map[i] = i;
+		} catch (std::bad_alloc &) {
+			thrown++;
+		}
+		arm(0);
+		if (!intact(map))
+			broken++;
+
+		Map copy;
+		arm(at % 8 + 1);
+		try {
+			copy[-1] = -1;
+			Map built(map);
+			copy = map;
+		} catch (std::bad_alloc &) {
+			thrown++;
+		}
+		arm(0);
+		if (!intact(copy))
+			broken++;
+	}
+	std::cout << "step " << step << ": " << (thrown > 0) << " " << broken << "\n";
+}
+
+//a value that throws while the map is still empty must not strand its node
+void tester2(void) {
+	{
+		BoomMap map;
+		try {
+			map.try_emplace(1, -1);
+		} catch (std::runtime_error &) {
+			std::cout << "throw ";
+		}
+		std::cout << map.size() << " ";
+		map.try_emplace(2, 2);
+		std::cout << map.size() << " " << map.at(2).val << "\n";
+	}
+	{
+		BoomMap map;
+		try {
+			map.try_emplace(1, -1);
+		} catch (std::runtime_error &) {
+			std::cout << "throw\n";
+		}
+	}
+}
+
+int main() {
+	tester(0);
+	tester(1);
+	tester(4);
+	tester2();
+	std::cout << liveBytes << "\n";
+	return 0;
+}
@@ -0,0 +1,166 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <string>
+
+typedef sjtu::linked_hashmap<int, std::string> Map;
+
+void dump(const Map &map) {
+	for (Map::const_iterator it = map.cbegin(); it != map.cend(); ++it) std::cout << it->first << " ";
+	std::cout << "\n";
+}
+
+bool intact(const Map &map, int n) {
+	if (map.size() != size_t(n)) return false;
+	for (int i = 0; i < n; i++)
+		if (map.count(i) != 1 || map.at(i) != std::to_string(i)) return false;
+	return true;
+}
+
+void tester1(void) {
+	Map map;
+	std::cout << map.access_order() << "\n";
+	map.set_access_order(true);
+	std::cout << map.access_order() << "\n";
+	for (int i = 0; i < 6; i++) map.insert(sjtu::pair<const int, std::string>(i, std::to_string(i)));
+	dump(map);
+
+	//every non-const hit moves its entry to the back
+	map.find(1);
+	dump(map);
+	map[2] = "two";
+	dump(map);
+	map.at(3);
+	dump(map);
+	*map.get_if(0) += "!";
+	dump(map);
+	std::cout << map.insert_or_assign(4, "four").second << "\n";
+	dump(map);
+
+	//misses, const lookups and insert() hits leave the order alone
+	std::cout << (map.find(42) == map.end()) << " " << (map.get_if(42) == nullptr) << "\n";
+	const Map &cmap = map;
+	std::cout << cmap.find(5)->second << " " << cmap.at(5) << " " << *cmap.get_if(5) << " " << cmap.count(5) << "\n";
+	sjtu::pair<Map::iterator, bool> res = map.insert(sjtu::pair<const int, std::string>(1, "one"));
+	std::cout << res.second << " " << res.first->second << "\n";
+	dump(map);
+
+	//an insertion goes to the back either way
+	map[6] = "6";
+	dump(map);
+
+	map.set_access_order(false);
+	map.find(5);
+	map[3];
+	map.insert_or_assign(0, "0");
+	dump(map);
+}
+
+void tester2(void) {
+	Map map;
+	for (int i = 0; i < 5; i++) map[i] = std::to_string(i);
+
+	//at the ends moving is a no-op
+	map.move_to_front(map.begin());
+	dump(map);
+	Map::iterator last = map.find(4);
+	map.move_to_back(last);
+	dump(map);
+
+	map.move_to_front(last);
+	dump(map);
+	map.move_to_back(map.begin());
+	dump(map);
+	map.move_to_back(map.find(2));
+	map.move_to_front(map.find(1));
+	dump(map);
+
+	try {
+		map.move_to_front(map.end());
+		std::cout << "no throw\n";
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "index_out_of_bound\n";
+	}
+	try {
+		map.move_to_back(map.end());
+		std::cout << "no throw\n";
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "index_out_of_bound\n";
+	}
+
+	Map one;
+	one[7] = "7";
+	one.move_to_front(one.begin());
+	one.move_to_back(one.begin());
+	dump(one);
+}
+
+void tester3(void) {
+	Map map;
+	std::cout << map.bucket_count() << " " << map.load_factor() << " " << map.max_load_factor() << "\n";
+
+	//after reserve(n), n insertions never resize the table
+	map.reserve(1000);
+	size_t buckets = map.bucket_count();
+	std::cout << (buckets * map.max_load_factor() >= 1000) << "\n";
+	for (int i = 0; i < 1000; i++) map[i] = std::to_string(i);
+	std::cout << (map.bucket_count() == buckets) << " " << intact(map, 1000) << "\n";
+
+	map.rehash(buckets * 4);
+	std::cout << (map.bucket_count() >= buckets * 4) << " " << intact(map, 1000) << "\n";
+	map.rehash(0);
+	std::cout << (map.bucket_count() == buckets) << " " << intact(map, 1000) << "\n";
+	map.reserve(10);
+	std::cout << (map.bucket_count() == buckets) << "\n";
+
+	//a lower maximum grows the table right away, and drags the shrink threshold down with it
+	map.max_load_factor(0.9f);
+	std::cout << map.max_load_factor() << " " << map.get_resize_policy().shrink_load << " " << (map.bucket_count() == buckets) << "\n";
+	map.max_load_factor(0.2f);
+	std::cout << map.max_load_factor() << " " << map.get_resize_policy().shrink_load << " " << (map.load_factor() <= 0.2f)
+	          << " " << intact(map, 1000) << "\n";
+
+	float bad[] = {0.0f, 1.0f, -0.5f, 1.5f};
+	for (int i = 0; i < 4; i++) {
+		try {
+			map.max_load_factor(bad[i]);
+			std::cout << "no throw ";
+		} catch (sjtu::runtime_error &) {
+			std::cout << "runtime_error ";
+		}
+	}
+	std::cout << map.max_load_factor() << " " << intact(map, 1000) << "\n";
+
+	map.clear();
+	map.rehash(0);
+	std::cout << map.bucket_count() << " " << map.size() << "\n";
+}
+
+void tester4(void) {
+	Map map;
+	for (int i = 0; i < 3; i++) map[i] = std::to_string(i);
+
+	std::string *found = map.get_if(1);
+	*found = "one";
+	std::cout << (found == &map.at(1)) << " " << map.at(1) << " " << (map.get_if(3) == nullptr) << "\n";
+	const Map &cmap = map;
+	std::cout << *cmap.get_if(2) << " " << (cmap.get_if(-1) == nullptr) << "\n";
+
+#ifdef SJTU_LINKEDHASHMAP_OPTIONAL
+	if (auto value = map.try_at(0)) value->get() = "zero";
+	std::cout << map.try_at(0).has_value() << " " << map.at(0) << " " << map.try_at(5).has_value() << "\n";
+	std::cout << cmap.try_at(1)->get() << " " << cmap.try_at(-1).has_value() << "\n";
+#else
+	//try_at() needs C++17; get_if() gives the same answers
+	if (std::string *value = map.get_if(0)) *value = "zero";
+	std::cout << (map.get_if(0) != nullptr) << " " << map.at(0) << " " << (map.get_if(5) != nullptr) << "\n";
+	std::cout << *cmap.get_if(1) << " " << (cmap.get_if(-1) != nullptr) << "\n";
+#endif
+}
+
+int main() {
+	tester1();
+	tester2();
+	tester3();
+	tester4();
+	return 0;
+}
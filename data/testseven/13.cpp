@@ -0,0 +1,97 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <utility>
+class Integer {
+public:
+	static int counter;
+	int val;
+	
+	Integer(int val) : val(val) {
+		counter++;
+	}
+
+	Integer(const Integer &rhs) {
+		val = rhs.val;
+		counter++;
+	}
+
+	Integer& operator = (const Integer &rhs) {
+		assert(false);
+	}
+
+	~Integer() {
+		counter--;
+	}
+};
+
+int Integer::counter = 0;
+
+class Equal {
+public:
+	bool operator () (const Integer &lhs, const Integer &rhs) const {
+		return lhs.val ==rhs.val;
+	}
+};
+class Hash {
+public:
+	unsigned int operator () (const Integer &lhs) const {
+		return std::hash<int>()(lhs.val); 
+	}
+};
+typedef sjtu::linked_hashmap<Integer,int,Hash,Equal> Map;
+
+Map makeMap(int from, int n) {
+	Map map;
+	for(int i=from;i<from+n;++i) map[Integer(i)] = i;
+	return map;
+}
+
+long long sum(const Map &map) {
+	long long ans=0;
+	for(Map::const_iterator it=map.cbegin();it!=map.cend();++it) ans+=it->first.val*3+it->second;
+	return ans;
+}
+
+void tester(void) {
+	Map a=makeMap(0,1000);
+	int before=Integer::counter;
+	Map b(std::move(a));
+	std::cout<<(Integer::counter==before)<<" "<<a.size()<<" "<<b.size()<<" "<<sum(b)<<"\n";
+
+	Map c=makeMap(5000,10);
+	before=Integer::counter;
+	c=std::move(b);
+	std::cout<<(Integer::counter==before-10)<<" "<<b.size()<<" "<<c.size()<<" "<<sum(c)<<"\n";
+
+	a[Integer(-1)]=7;
+	Map::iterator it=a.find(Integer(-1));
+	before=Integer::counter;
+	a.swap(c);
+	std::cout<<(Integer::counter==before)<<" "<<a.size()<<" "<<c.size()<<" "<<it->second<<" "<<(it==c.begin())<<"\n";
+	sjtu::swap(a,c);
+	std::cout<<a.size()<<" "<<c.size()<<" "<<sum(c)<<"\n";
+
+	b[Integer(42)]=42;
+	b=std::move(b);
+	std::cout<<b.size()<<" "<<b.at(Integer(42))<<"\n";
+
+	std::cout<<std::is_nothrow_move_constructible<Map>::value<<" "<<std::is_nothrow_move_assignable<Map>::value<<"\n";
+	std::vector<Map> maps;
+	for(int i=0;i<50;++i) maps.push_back(makeMap(i*100,100));
+	before=Integer::counter;
+	maps.reserve(maps.capacity()*4);
+	maps.erase(maps.begin());
+	long long total=0;
+	for(size_t i=0;i<maps.size();++i) total+=sum(maps[i]);
+	std::cout<<(Integer::counter==before-100)<<" "<<maps.size()<<" "<<total<<"\n";
+}
+
+int main(void) {
+	std::ios::sync_with_stdio(false);
+	std::cin.tie(0);
+	std::cout.tie(0);
+	tester();
+	std::cout << Integer::counter << std::endl;
+}
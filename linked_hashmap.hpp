@@ -6,60 +6,519 @@
 
 // only for std::equal_to<T> and std::hash<T>
 #include <functional>
+#include <type_traits>
 #include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <cstdint>
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define SJTU_LINKEDHASHMAP_PMR 1
+#endif
+#if __has_include(<optional>)
+#include <optional>
+#define SJTU_LINKEDHASHMAP_OPTIONAL 1
+#endif
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define SJTU_LINKEDHASHMAP_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define SJTU_LINKEDHASHMAP_PREFETCH(addr) ((void) (addr))
+#endif
 #include "utility.hpp"
 #include "exceptions.hpp"
 
 namespace sjtu {
 
+    /**
+     * when a linked_hashmap resizes its bucket table.
+     * the table doubles once size() exceeds grow_load * bucket count and
+     * halves once size() drops below shrink_load * bucket count; keeping
+     * shrink_load well under grow_load / 2 leaves a gap so that a workload
+     * hovering around one threshold does not rebuild the table over and over.
+     */
+    struct resize_policy {
+        float grow_load;
+        float shrink_load;
+        size_t min_buckets; //never shrink below this many buckets
+        bool shrink; //false keeps the table at its largest size
+
+        explicit resize_policy(float grow_load = 0.5f, float shrink_load = 0.125f,
+                               size_t min_buckets = 16, bool shrink = true)
+                : grow_load(grow_load), shrink_load(shrink_load), min_buckets(min_buckets), shrink(shrink) {}
+    };
+
+    /**
+     * a hash policy maps a hash value to its home slot and decides which
+     * table sizes are allowed. linked_hashmap uses Hash::hash_policy when
+     * the hasher declares one and fibonacci_hash_policy otherwise.
+     */
+
+    /**
+     * multiplies by 2^64 / phi and keeps the top bits, so weak hashes such
+     * as the identity std::hash<int> still spread over a power-of-2 table
+     */
+    struct fibonacci_hash_policy {
+        int shift;
+
+        fibonacci_hash_policy() : shift(0) {}
+
+        static size_t round_size(size_t n) {
+            size_t size = 1;
+            while (size < n)
+                size *= 2;
+            return size;
+        }
+
+        void set_size(size_t size) {
+            shift = sizeof(size_t) * 8;
+            while (size > 1) {
+                size /= 2;
+                shift--;
+            }
+        }
+
+        size_t index(size_t hashVal) const {
+            if (shift == int(sizeof(size_t) * 8))
+                return 0;
+            const size_t golden = sizeof(size_t) == 8 ? size_t(11400714819323198485ull) : size_t(2654435769u);
+            return (hashVal * golden) >> shift;
+        }
+    };
+
+    /**
+     * keeps the low bits of the hash; for hashes that are already well mixed
+     */
+    struct power_of_two_hash_policy {
+        size_t mask;
+
+        power_of_two_hash_policy() : mask(0) {}
+
+        static size_t round_size(size_t n) {
+            return fibonacci_hash_policy::round_size(n);
+        }
+
+        void set_size(size_t size) {
+            mask = size - 1;
+        }
+
+        size_t index(size_t hashVal) const {
+            return hashVal & mask;
+        }
+    };
+
+    /**
+     * prime table sizes and a plain modulo, for hashes tuned to them
+     */
+    struct prime_hash_policy {
+        size_t prime;
+
+        prime_hash_policy() : prime(1) {}
+
+        static size_t round_size(size_t n) {
+            if (n <= 2)
+                return 2;
+            size_t size = n | 1;
+            for (;; size += 2) {
+                bool isPrime = true;
+                for (size_t d = 3; d <= size / d; d += 2)
+                    if (size % d == 0) {
+                        isPrime = false;
+                        break;
+                    }
+                if (isPrime)
+                    return size;
+            }
+        }
+
+        void set_size(size_t size) {
+            prime = size;
+        }
+
+        size_t index(size_t hashVal) const {
+            return hashVal % prime;
+        }
+    };
+
+    template<class...>
+    struct make_void {
+        typedef void type;
+    };
+
+    template<class Hash, class = void>
+    struct hash_policy_of {
+        typedef fibonacci_hash_policy type;
+    };
+
+    template<class Hash>
+    struct hash_policy_of<Hash, typename make_void<typename Hash::hash_policy>::type> {
+        typedef typename Hash::hash_policy type;
+    };
+
+    /**
+     * whether Hash and Equal both declare is_transparent, letting
+     * linked_hashmap look up keys of other types without building a Key
+     */
+    template<class Hash, class Equal, class = void>
+    struct transparent_lookup : std::false_type {
+    };
+
+    template<class Hash, class Equal>
+    struct transparent_lookup<Hash, Equal,
+            typename make_void<typename Hash::is_transparent, typename Equal::is_transparent>::type>
+            : std::true_type {
+    };
+
+    /**
+     * whether linked_hashmap keeps each key's hash in its node, so rebuilding
+     * the index or unlinking a displaced slot never calls Hash again.
+     * keys that hash in a couple of instructions skip the extra word;
+     * specialize for other key types.
+     */
+    template<class Key>
+    struct store_hash : std::integral_constant<bool,
+            !std::is_arithmetic<Key>::value && !std::is_enum<Key>::value && !std::is_pointer<Key>::value> {
+    };
+
+    /**
+     * the per-node hash record, empty when the hash is not stored
+     */
+    template<bool stored>
+    struct hash_cache {
+        size_t hashVal;
+
+        hash_cache() : hashVal(0) {}
+
+        void keep(size_t keyHash) {
+            hashVal = keyHash;
+        }
+
+        template<class Hash, class Key>
+        size_t recall(const Hash &, const Key &) const {
+            return hashVal;
+        }
+    };
+
+    template<>
+    struct hash_cache<false> {
+        void keep(size_t) {}
+
+        template<class Hash, class Key>
+        size_t recall(const Hash &getHash, const Key &key) const {
+            return getHash(key);
+        }
+    };
+
+    /**
+     * whether Alloc's destroy() does nothing but run the destructor, so a
+     * linked_hashmap of trivially destructible elements may drop its nodes
+     * without visiting them. specialize for other such allocators.
+     */
+    template<class Alloc>
+    struct plain_destroy : std::false_type {
+    };
+
+    template<class U>
+    struct plain_destroy<std::allocator<U> > : std::true_type {
+    };
+
+#ifdef SJTU_LINKEDHASHMAP_PMR
+    template<class U>
+    struct plain_destroy<std::pmr::polymorphic_allocator<U> > : std::true_type {
+    };
+#endif
+
     template<
             class Key,
             class T,
             class Hash = std::hash<Key>,
-            class Equal = std::equal_to<Key>
+            class Equal = std::equal_to<Key>,
+            class Allocator = std::allocator<pair<const Key, T> >
     >
     class linked_hashmap {
 
+        using allocTraits = std::allocator_traits<Allocator>;
+
+        template<class U>
+        using rebindAlloc = typename allocTraits::template rebind_alloc<U>;
+
         template<class elemType>
         class LinkedList {
         public:
+            /**
+             * links only; the head and tail sentinels are bare LinkedNodes
+             */
             class LinkedNode {
             public:
-                elemType *val;
                 LinkedNode *prev, *next;
 
-                LinkedNode() : val(nullptr), prev(nullptr), next(nullptr) {}
+                LinkedNode() : prev(nullptr), next(nullptr) {}
+            };
+
+            /**
+             * an element node, the value lives inside the node itself
+             * so one allocation covers both links and data
+             */
+            class ValueNode : public LinkedNode, public hash_cache<store_hash<Key>::value> {
+            public:
+                //hash table slot this node was placed in, see BucketTable::placedAt();
+                //only a hint, so truncation on tables of 2^32 slots or more is harmless
+                std::uint32_t slot;
+                std::uint32_t loose; //1 if the node has storage of its own instead of a pool slot
+                union {
+                    elemType val; //constructed and destroyed through the allocator
+                };
+
+                ValueNode() : slot(0), loose(0) {}
+
+                ~ValueNode() {}
+            };
+
+            /**
+             * raw storage for ValueNodes, carved out of slabs that double in
+             * size up to maxSlab nodes. erased nodes go on a free list and are
+             * reused before the slabs grow, so insert/erase churn stays off the
+             * global allocator.
+             *
+             * a node that leaves its map on its own (through a node handle or
+             * splice()) must not keep the slabs alive, so it is moved into
+             * storage of its own or of the other map's pool first, see
+             * takeLoose(). merge() hands the slabs over whole, see absorb();
+             * either way the slabs die with the pool that holds them.
+             */
+            class NodePool {
+            private:
+                typedef typename std::aligned_storage<sizeof(ValueNode), alignof(ValueNode)>::type NodeStorage;
+
+                using storageTraits = std::allocator_traits<rebindAlloc<NodeStorage> >;
+
+                struct FreeNode {
+                    FreeNode *next;
+                };
+
+                //the first NodeStorage of every slab holds this header
+                struct SlabHeader {
+                    NodeStorage *next;
+                    size_t count;
+                };
+
+                static const size_t minSlab = 16;
+                static const size_t maxSlab = 4096;
+
+                NodeStorage *slabs; //most recent slab first
+                NodeStorage *bump, *bumpEnd; //untouched part of the newest slab
+                FreeNode *freeList;
+
+                void grow(const Allocator &alloc) {
+                    size_t count = slabs == nullptr ? minSlab : reinterpret_cast<SlabHeader *>(slabs)->count * 2;
+                    if (count > maxSlab)
+                        count = maxSlab;
+                    carve(count, alloc);
+                }
+
+                /**
+                 * starts a new slab of count storages, the header included
+                 */
+                void carve(size_t count, const Allocator &alloc) {
+                    rebindAlloc<NodeStorage> storageAlloc(alloc);
+                    NodeStorage *slab = storageTraits::allocate(storageAlloc, count);
+                    SlabHeader *header = reinterpret_cast<SlabHeader *>(slab);
+                    header->next = slabs;
+                    header->count = count;
+                    slabs = slab;
+                    bump = slab + 1;
+                    bumpEnd = slab + count;
+                }
+
+            public:
+                NodePool() : slabs(nullptr), bump(nullptr), bumpEnd(nullptr), freeList(nullptr) {
+                    static_assert(sizeof(SlabHeader) <= sizeof(NodeStorage), "slab header must fit in one node");
+                    static_assert(sizeof(FreeNode) <= sizeof(NodeStorage), "a free node must fit in one node");
+                }
+
+                NodePool(const NodePool &) = delete;
+
+                NodePool &operator=(const NodePool &) = delete;
+
+                void swap(NodePool &other) {
+                    std::swap(slabs, other.slabs);
+                    std::swap(bump, other.bump);
+                    std::swap(bumpEnd, other.bumpEnd);
+                    std::swap(freeList, other.freeList);
+                }
+
+                void *take(const Allocator &alloc) {
+                    if (freeList != nullptr) {
+                        FreeNode *node = freeList;
+                        freeList = node->next;
+                        return node;
+                    }
+                    if (bump == bumpEnd)
+                        grow(alloc);
+                    return bump++;
+                }
+
+                /**
+                 * makes sure the next n nodes are carved without allocating:
+                 * unless the newest slab still has n untouched nodes, its rest
+                 * goes on the free list and one slab of n nodes follows.
+                 * nodes already on the free list are not counted.
+                 */
+                void reserve(size_t n, const Allocator &alloc) {
+                    if (static_cast<size_t>(bumpEnd - bump) >= n)
+                        return;
+                    while (bump != bumpEnd)
+                        give(bump++);
+                    carve(n + 1, alloc);
+                }
+
+                void give(void *node) {
+                    FreeNode *freed = static_cast<FreeNode *>(node);
+                    freed->next = freeList;
+                    freeList = freed;
+                }
+
+                /**
+                 * takes over other's slabs and free nodes without allocating,
+                 * leaving other empty; the untouched rest of its newest slab
+                 * goes on the free list. the slabs go in behind the newest one
+                 * here, so growth carries on from that.
+                 */
+                void absorb(NodePool &other) {
+                    if (other.slabs == nullptr)
+                        return;
+                    while (other.bump != other.bumpEnd)
+                        other.give(other.bump++);
+
+                    if (other.freeList != nullptr) {
+                        FreeNode *last = other.freeList;
+                        while (last->next != nullptr)
+                            last = last->next;
+                        last->next = freeList;
+                        freeList = other.freeList;
+                    }
+
+                    SlabHeader *last = reinterpret_cast<SlabHeader *>(other.slabs);
+                    while (last->next != nullptr)
+                        last = reinterpret_cast<SlabHeader *>(last->next);
+                    if (slabs == nullptr) {
+                        slabs = other.slabs;
+                    } else {
+                        SlabHeader *newest = reinterpret_cast<SlabHeader *>(slabs);
+                        last->next = newest->next;
+                        newest->next = other.slabs;
+                    }
+
+                    other.slabs = nullptr;
+                    other.bump = other.bumpEnd = nullptr;
+                    other.freeList = nullptr;
+                }
 
-                explicit LinkedNode(const elemType &other) : prev(nullptr), next(nullptr) {
-                    val = new elemType(other);
+                /**
+                 * storage for one node outside any slab, for a node that may
+                 * outlive the pool it was made for
+                 */
+                static void *takeLoose(const Allocator &alloc) {
+                    rebindAlloc<NodeStorage> storageAlloc(alloc);
+                    return storageTraits::allocate(storageAlloc, 1);
                 }
 
-                LinkedNode(const LinkedNode &other) : prev(nullptr), next(nullptr) {
-                    val = new elemType(*(other.val));
+                static void giveLoose(void *node, const Allocator &alloc) {
+                    rebindAlloc<NodeStorage> storageAlloc(alloc);
+                    storageTraits::deallocate(storageAlloc, static_cast<NodeStorage *>(node), 1);
                 }
 
-                ~LinkedNode() {
-                    if (val != nullptr) {
-                        delete val;
-                        val = nullptr;
+                /**
+                 * frees every slab; only once no node carved from them is alive
+                 */
+                void release(const Allocator &alloc) {
+                    rebindAlloc<NodeStorage> storageAlloc(alloc);
+                    while (slabs != nullptr) {
+                        SlabHeader *header = reinterpret_cast<SlabHeader *>(slabs);
+                        NodeStorage *next = header->next;
+                        storageTraits::deallocate(storageAlloc, slabs, header->count);
+                        slabs = next;
                     }
+                    bump = bumpEnd = nullptr;
+                    freeList = nullptr;
                 }
             };
 
+            using linkTraits = std::allocator_traits<rebindAlloc<LinkedNode> >;
+
         public:
-            LinkedNode *head, *tail;
+            LinkedNode *head, *tail; //both stay nullptr until the first element is linked
+            NodePool pool;
+            size_t looseCount; //linked nodes that came in through node handles, see ValueNode::loose
+            Allocator alloc; //every node, slab and sentinel of the list comes from here
+
+            explicit LinkedList(const Allocator &allocator = Allocator())
+                    : head(nullptr), tail(nullptr), looseCount(0), alloc(allocator) {}
+
+            LinkedList(LinkedList &&other) noexcept
+                    : head(other.head), tail(other.tail), looseCount(other.looseCount), alloc(std::move(other.alloc)) {
+                pool.swap(other.pool);
+                other.head = other.tail = nullptr;
+                other.looseCount = 0;
+            }
 
-            LinkedList() {
-                head = new LinkedNode;
-                tail = new LinkedNode;
-                head->next = tail;
-                tail->prev = head;
+            /**
+             * exchanges nodes, slabs and sentinels; the allocators too if
+             * Propagate is std::true_type
+             */
+            template<class Propagate>
+            void swap(LinkedList &other, Propagate propagate) {
+                std::swap(head, other.head);
+                std::swap(tail, other.tail);
+                pool.swap(other.pool);
+                std::swap(looseCount, other.looseCount);
+                swapAlloc(other, propagate);
+            }
+
+            void swapAlloc(LinkedList &other, std::true_type) {
+                using std::swap;
+                swap(alloc, other.alloc);
             }
 
+            void swapAlloc(LinkedList &, std::false_type) {}
+
+            /**
+             * with propagate_on_container_copy_assignment, memory from the old
+             * allocator goes back to it before rhs's allocator is taken over
+             */
+            void adoptAlloc(const LinkedList &rhs, std::true_type) {
+                if (alloc != rhs.alloc)
+                    freeSentinels();
+                alloc = rhs.alloc;
+            }
+
+            void adoptAlloc(const LinkedList &, std::false_type) {}
+
             ~LinkedList() {
                 clear();
-                delete head;
-                delete tail;
+                freeSentinels();
+            }
+
+            void initSentinels() {
+                rebindAlloc<LinkedNode> linkAlloc(alloc);
+                head = linkTraits::allocate(linkAlloc, 2);
+                tail = head + 1;
+                linkTraits::construct(linkAlloc, head);
+                linkTraits::construct(linkAlloc, tail);
+                head->next = tail;
+                tail->prev = head;
+            }
+
+            void freeSentinels() {
+                if (head == nullptr)
+                    return;
+                rebindAlloc<LinkedNode> linkAlloc(alloc);
+                linkTraits::destroy(linkAlloc, tail);
+                linkTraits::destroy(linkAlloc, head);
+                linkTraits::deallocate(linkAlloc, head, 2);
+                head = tail = nullptr;
             }
 
             LinkedNode *insert(LinkedNode *pos, LinkedNode *cur) {
@@ -80,15 +539,21 @@ namespace sjtu {
                 return pos;
             }
 
-            LinkedList(const LinkedList &other) {
-                head = new LinkedNode;
-                tail = new LinkedNode;
-                head->next = tail;
-                tail->prev = head;
-                LinkedNode *cur = other.head->next;
-                while (cur != other.tail) {
-                    pushBack(*(cur->val));
-                    cur = cur->next;
+            LinkedList(const LinkedList &other, const Allocator &allocator)
+                    : head(nullptr), tail(nullptr), looseCount(0), alloc(allocator) {
+                if (other.head == nullptr)
+                    return;
+                //no destructor runs for a constructor that throws
+                try {
+                    LinkedNode *cur = other.head->next;
+                    while (cur != other.tail) {
+                        cloneBack(static_cast<ValueNode *>(cur));
+                        cur = cur->next;
+                    }
+                } catch (...) {
+                    clear();
+                    freeSentinels();
+                    throw;
                 }
             }
 
@@ -97,69 +562,432 @@ namespace sjtu {
                     return *this;
 
                 clear();
-                delete head;
-                delete tail;
-
-                head = new LinkedNode;
-                tail = new LinkedNode;
-                head->next = tail;
-                tail->prev = head;
-
+                adoptAlloc(rhs, typename allocTraits::propagate_on_container_copy_assignment());
+                if (rhs.head == nullptr)
+                    return *this;
 
                 LinkedNode *cur = (rhs.head)->next;
                 while (cur != rhs.tail) {
-                    pushBack(*(cur->val));
+                    cloneBack(static_cast<ValueNode *>(cur));
                     cur = cur->next;
                 }
 
                 return *this;
             }
 
+            /**
+             * nothing to run per node: the slabs can be dropped as they are,
+             * unless some nodes have storage of their own to free
+             */
+            static const bool trivialTeardown = std::is_trivially_destructible<elemType>::value
+                                                && plain_destroy<Allocator>::value;
+
+            /**
+             * the pool is released even without sentinels: a first node can be
+             * carved before they exist, and go back unlinked if that insert throws
+             */
             void clear() {
-                LinkedNode *cur = head->next;
+                if (head == nullptr) {
+                    pool.release(alloc);
+                    return;
+                }
+                LinkedNode *cur = trivialTeardown && looseCount == 0 ? tail : head->next;
                 while (cur != tail) {
                     LinkedNode *tmp = cur->next;
-                    delete remove(cur);
+                    ValueNode *pos = static_cast<ValueNode *>(cur);
+                    destroyNode(pos);
+                    if (pos->loose)
+                        NodePool::giveLoose(pos, alloc);
                     cur = tmp;
                 }
+                looseCount = 0;
+                head->next = tail;
+                tail->prev = head;
+                pool.release(alloc);
             }
 
             bool empty() const {
-                return head->next == tail;
+                return head == nullptr || head->next == tail;
+            }
+
+            void destroyNode(ValueNode *pos) {
+                allocTraits::destroy(alloc, &pos->val);
+                pos->~ValueNode();
+            }
+
+            /**
+             * destroys the value and returns the node's storage to the pool,
+             * or to the allocator if it has storage of its own
+             */
+            void recycle(ValueNode *pos) {
+                bool loose = pos->loose;
+                destroyNode(pos);
+                if (loose)
+                    NodePool::giveLoose(pos, alloc);
+                else
+                    pool.give(pos);
+            }
+
+            /**
+             * unlinks and frees a linked node
+             */
+            void erase(ValueNode *pos) {
+                remove(pos);
+                if (pos->loose)
+                    looseCount--;
+                recycle(pos);
+            }
+
+            /**
+             * builds a node with its value constructed in place from args,
+             * not yet linked into the list
+             */
+            template<class... Args>
+            ValueNode *makeNode(Args &&... args) {
+                ValueNode *newIns = new(pool.take(alloc)) ValueNode;
+                try {
+                    allocTraits::construct(alloc, &newIns->val, std::forward<Args>(args)...);
+                } catch (...) {
+                    newIns->~ValueNode();
+                    pool.give(newIns);
+                    throw;
+                }
+                return newIns;
+            }
+
+            /**
+             * builds an unlinked node holding pos's value, stored hash included,
+             * in a slot of this pool or, if loose, in storage of its own.
+             * the value is moved over when neither half can throw while moving
+             * and copied otherwise, so pos keeps its value if this throws.
+             */
+            ValueNode *relocate(ValueNode *pos, bool loose) {
+                ValueNode *newIns = new(loose ? NodePool::takeLoose(alloc) : pool.take(alloc)) ValueNode;
+                newIns->loose = loose;
+                try {
+                    relocateValue(&newIns->val, pos->val, std::integral_constant<bool,
+                            std::is_nothrow_move_constructible<Key>::value
+                            && std::is_nothrow_move_constructible<T>::value>());
+                } catch (...) {
+                    newIns->~ValueNode();
+                    if (loose)
+                        NodePool::giveLoose(newIns, alloc);
+                    else
+                        pool.give(newIns);
+                    throw;
+                }
+                static_cast<hash_cache<store_hash<Key>::value> &>(*newIns) = *pos;
+                return newIns;
+            }
+
+            //the key is const only towards users; pos's value is destroyed right after
+            void relocateValue(elemType *dst, elemType &src, std::true_type) {
+                allocTraits::construct(alloc, dst, std::move(const_cast<Key &>(src.first)),
+                                       std::move(src.second));
+            }
+
+            void relocateValue(elemType *dst, elemType &src, std::false_type) {
+                allocTraits::construct(alloc, dst, src.first, std::move_if_noexcept(src.second));
+            }
+
+            /**
+             * undoes makeNode for a node that was never linked
+             */
+            void dropNode(ValueNode *pos) {
+                destroyNode(pos);
+                pool.give(pos);
+            }
+
+            /**
+             * unlinks a node with storage of its own, handing it to the caller
+             */
+            void detach(ValueNode *pos) {
+                remove(pos);
+                looseCount--;
+            }
+
+            /**
+             * links pos in front of next (nullptr for the tail); a node with
+             * storage of its own, e.g. from a node handle, is counted as such.
+             * only initializing the sentinels can throw, and pos stays unlinked then.
+             */
+            ValueNode *linkBefore(LinkedNode *next, ValueNode *pos) {
+                if (head == nullptr)
+                    initSentinels();
+                insert((next == nullptr ? tail : next)->prev, pos);
+                if (pos->loose)
+                    looseCount++;
+                return pos;
             }
 
-            void erase(LinkedNode *pos) {
-                delete remove(pos);
+            /**
+             * moves the nodes [first, last) of this list in front of pos,
+             * which must not lie strictly inside the range
+             */
+            void spliceRange(LinkedNode *pos, LinkedNode *first, LinkedNode *last) {
+                if (first == last || pos == first || pos == last)
+                    return;
+                LinkedNode *lastIn = last->prev;
+                first->prev->next = last;
+                last->prev = first->prev;
+
+                LinkedNode *before = pos->prev;
+                before->next = first;
+                first->prev = before;
+                lastIn->next = pos;
+                pos->prev = lastIn;
             }
 
-            LinkedNode *pushBack(const elemType &val) {
-                LinkedNode *newIns = new LinkedNode(val);
+            ValueNode *linkBack(ValueNode *newIns) {
+                if (head == nullptr) {
+                    try {
+                        initSentinels();
+                    } catch (...) {
+                        dropNode(newIns);
+                        throw;
+                    }
+                }
                 insert(tail->prev, newIns);
                 return newIns;
             }
+
+            template<class... Args>
+            ValueNode *emplaceBack(Args &&... args) {
+                return linkBack(makeNode(std::forward<Args>(args)...));
+            }
+
+            /**
+             * appends a copy of other, stored hash included
+             */
+            ValueNode *cloneBack(const ValueNode *other) {
+                ValueNode *newIns = emplaceBack(other->val);
+                static_cast<hash_cache<store_hash<Key>::value> &>(*newIns) = *other;
+                return newIns;
+            }
         };
 
 
     public:
         typedef pair<const Key, T> value_type;
 
+        typedef Allocator allocator_type;
+
         friend class iterator;
 
         friend class const_iterator;
 
     private:
-        using dataNode = typename LinkedList<value_type>::LinkedNode; //ptr to the nodes in elemTable
+        using linkNode = typename LinkedList<value_type>::LinkedNode; //links of elemTable, also its sentinels
+
+        using dataNode = typename LinkedList<value_type>::ValueNode; //the nodes in elemTable holding the elements
+
+        /**
+         * one slot of the open-addressing index.
+         * the hash is cached next to the pointer so a probe can reject a
+         * mismatching slot without touching the node it points to.
+         */
+        struct Bucket {
+            dataNode *node; //nullptr marks an empty slot
+            size_t hashVal;
+        };
+
+        using indexPolicy = typename hash_policy_of<Hash>::type;
+
+        /**
+         * a flat robin hood table of Buckets with linear probing.
+         * capacity is a size indexPolicy accepts, or 0 before anything is allocated.
+         */
+        struct BucketTable {
+            Bucket *slots;
+            size_t capacity;
+            indexPolicy indexer;
+
+            BucketTable() : slots(nullptr), capacity(0) {}
+
+            using bucketTraits = std::allocator_traits<rebindAlloc<Bucket> >;
+
+            /**
+             * with the default allocator, calloc rather than new Bucket[cap]()
+             * so a big table comes back as lazily zeroed pages instead of being
+             * cleared up front, which would stall the operation that triggers
+             * a resize
+             */
+            static const bool useCalloc = std::is_same<rebindAlloc<Bucket>, std::allocator<Bucket> >::value;
+
+            /**
+             * takes a fresh array of cap empty slots; the table is untouched
+             * if the allocation throws. the old slots are not released.
+             */
+            void allocate(size_t cap, const Allocator &alloc) {
+                Bucket *fresh = nullptr;
+                if (cap != 0) {
+                    if (useCalloc) {
+                        fresh = static_cast<Bucket *>(std::calloc(cap, sizeof(Bucket)));
+                        if (fresh == nullptr)
+                            throw std::bad_alloc();
+                    } else {
+                        rebindAlloc<Bucket> bucketAlloc(alloc);
+                        fresh = bucketTraits::allocate(bucketAlloc, cap);
+                        for (size_t i = 0; i < cap; i++)
+                            fresh[i].node = nullptr;
+                    }
+                    indexer.set_size(cap);
+                }
+                slots = fresh;
+                capacity = cap;
+            }
+
+            void release(const Allocator &alloc) {
+                if (useCalloc) {
+                    std::free(slots);
+                } else if (slots != nullptr) {
+                    rebindAlloc<Bucket> bucketAlloc(alloc);
+                    bucketTraits::deallocate(bucketAlloc, slots, capacity);
+                }
+                slots = nullptr;
+                capacity = 0;
+            }
+
+            size_t nextSlot(size_t idx) const {
+                return idx + 1 == capacity ? 0 : idx + 1;
+            }
+
+            size_t home(size_t keyHash) const {
+                return indexer.index(keyHash);
+            }
+
+            /**
+             * how far the entry in slot idx sits from the slot its hash maps to
+             */
+            size_t probeDistance(size_t idx) const {
+                size_t start = home(slots[idx].hashVal);
+                return idx >= start ? idx - start : idx + capacity - start;
+            }
+
+            /**
+             * asks the cache for the home slot of keyHash ahead of a lookup
+             */
+            void prefetchHome(size_t keyHash) const {
+                if (capacity != 0)
+                    SJTU_LINKEDHASHMAP_PREFETCH(slots + home(keyHash));
+            }
+
+            /**
+             * walks the probe sequence of keyHash like findNode, looking at the
+             * stored hashes only, and asks the cache for the first node whose
+             * hash matches; that node is almost always the one findNode returns
+             */
+            void prefetchNode(size_t keyHash) const {
+                if (capacity == 0)
+                    return;
+                size_t idx = home(keyHash);
+                for (size_t dist = 0; slots[idx].node != nullptr; dist++) {
+                    if (probeDistance(idx) < dist)
+                        return;
+                    if (slots[idx].hashVal == keyHash) {
+                        SJTU_LINKEDHASHMAP_PREFETCH(slots[idx].node);
+                        return;
+                    }
+                    idx = nextSlot(idx);
+                }
+            }
+
+            /**
+             * returns the node holding key, or nullptr if key is absent.
+             * robin hood ordering lets a miss stop as soon as it meets an entry
+             * closer to its home than the probe is to ours.
+             */
+            template<class K>
+            dataNode *findNode(const K &key, size_t keyHash, const Equal &judgeEqual) const {
+                if (capacity == 0)
+                    return nullptr;
+                size_t idx = home(keyHash);
+                for (size_t dist = 0; slots[idx].node != nullptr; dist++) {
+                    if (probeDistance(idx) < dist)
+                        break;
+                    if (slots[idx].hashVal == keyHash && judgeEqual(key, slots[idx].node->val.first))
+                        return slots[idx].node;
+                    idx = nextSlot(idx);
+                }
+                return nullptr;
+            }
+
+            void place(dataNode *dataPos, size_t keyHash) {
+                Bucket carry = {dataPos, keyHash};
+                size_t idx = home(keyHash);
+                size_t landed = capacity;
+                for (size_t dist = 0; slots[idx].node != nullptr; dist++) {
+                    size_t cur = probeDistance(idx);
+                    if (cur < dist) {
+                        if (landed == capacity)
+                            landed = idx;
+                        Bucket tmp = slots[idx];
+                        slots[idx] = carry;
+                        carry = tmp;
+                        dist = cur;
+                    }
+                    idx = nextSlot(idx);
+                }
+                if (landed == capacity)
+                    landed = idx;
+                slots[idx] = carry;
+                dataPos->slot = static_cast<std::uint32_t>(landed);
+            }
+
+            /**
+             * the node remembers the slot it was placed in; entries displaced
+             * or shifted afterwards are not chased down (that would cost a
+             * cache miss on a cold node per moved slot), so the record may be
+             * stale and has to be checked.
+             */
+            bool placedAt(const dataNode *dataPos) const {
+                return dataPos->slot < capacity && slots[dataPos->slot].node == dataPos;
+            }
+
+            /**
+             * returns the slot pointing at dataPos, or capacity if there is none
+             */
+            size_t probeFor(const dataNode *dataPos, size_t keyHash) const {
+                if (capacity == 0)
+                    return capacity;
+                size_t idx = home(keyHash);
+                while (slots[idx].node != nullptr) {
+                    if (slots[idx].node == dataPos)
+                        return idx;
+                    idx = nextSlot(idx);
+                }
+                return capacity;
+            }
 
-        using ptrNode = typename LinkedList<dataNode *>::LinkedNode; //secondary pointer , point to the actual nodes
+            /**
+             * backward-shift deletion: every following entry that is not at its
+             * home slot moves one step back, so no tombstones are needed.
+             */
+            void remove(size_t hole) {
+                size_t idx = nextSlot(hole);
+                while (slots[idx].node != nullptr && probeDistance(idx) != 0) {
+                    slots[hole] = slots[idx];
+                    hole = idx;
+                    idx = nextSlot(idx);
+                }
+                slots[hole].node = nullptr;
+            }
+        };
 
         Hash getHash;
         Equal judgeEqual;
 
 
-        LinkedList<dataNode *> *hashList;
+        static const size_t initCapacity = 16;
+
+        BucketTable hashTable; //where new entries go
+        BucketTable oldTable; //only allocated while an incremental rehash drains it into hashTable
+        size_t migratePos; //slots of oldTable below this are already drained
+        size_t migrateStep; //least oldTable slots drained per insert/erase, 0 to rehash all at once
         LinkedList<value_type> elemTable;
-        size_t capacity, loadFactor;
+        resize_policy policy;
         size_t totLength;
+        bool accessOrder; //non-const lookups that hit move their entry to the back
 
     public:
 
@@ -176,8 +1004,8 @@ namespace sjtu {
             friend class linked_hashmap;
 
         private:
-            dataNode *iter;
-            dataNode *identity;
+            linkNode *iter;
+            linkNode *identity;
             /**
              * TODO add data members
              *   just add whatever you want.
@@ -203,13 +1031,15 @@ namespace sjtu {
                 identity = other.identity;
             }
 
+            iterator &operator=(const iterator &other) = default;
+
             iterator(const_iterator other) {
                 // TODO
                 iter = other.iter;
                 identity = other.identity;
             }
 
-            iterator(dataNode *other, dataNode *head) {
+            iterator(linkNode *other, linkNode *head) {
                 // TODO
                 iter = other;
                 identity = head;
@@ -221,7 +1051,7 @@ namespace sjtu {
             iterator operator++(int) {
                 iterator ret = *this;
 
-                if (iter->next == nullptr)
+                if (iter == nullptr || iter->next == nullptr)
                     throw invalid_iterator();
 
                 iter = iter->next;
@@ -232,7 +1062,7 @@ namespace sjtu {
              * TODO ++iter
              */
             iterator &operator++() {
-                if (iter->next == nullptr)
+                if (iter == nullptr || iter->next == nullptr)
                     throw invalid_iterator();
                 iter = iter->next;
                 return *this;
@@ -244,7 +1074,7 @@ namespace sjtu {
             iterator operator--(int) {
                 iterator ret = *this;
 
-                if ((iter->prev)->prev == nullptr)
+                if (iter == nullptr || (iter->prev)->prev == nullptr)
                     throw invalid_iterator();
 
                 iter = iter->prev;
@@ -255,7 +1085,7 @@ namespace sjtu {
              * TODO --iter
              */
             iterator &operator--() {
-                if ((iter->prev)->prev == nullptr)
+                if (iter == nullptr || (iter->prev)->prev == nullptr)
                     throw invalid_iterator();
 
                 iter = iter->prev;
@@ -264,7 +1094,7 @@ namespace sjtu {
 
 
             value_type &operator*() const {
-                return *(iter->val);
+                return static_cast<dataNode *>(iter)->val;
             }
 
             bool operator==(const iterator &rhs) const {
@@ -294,7 +1124,7 @@ namespace sjtu {
 
 
             value_type *operator->() const noexcept {
-                return (iter->val);
+                return &(static_cast<dataNode *>(iter)->val);
             }
         };
 
@@ -304,8 +1134,8 @@ namespace sjtu {
         private:
             friend class linked_hashmap;
 
-            dataNode *iter;
-            dataNode *identity;
+            linkNode *iter;
+            linkNode *identity;
             // data members.
         public:
             const_iterator() {
@@ -318,7 +1148,9 @@ namespace sjtu {
                 identity = other.identity;
             }
 
-            const_iterator(dataNode *other, dataNode *head) {
+            const_iterator &operator=(const const_iterator &other) = default;
+
+            const_iterator(linkNode *other, linkNode *head) {
                 // TODO
                 iter = other;
                 identity = head;
@@ -333,7 +1165,7 @@ namespace sjtu {
             const_iterator operator++(int) {
                 const_iterator ret = *this;
 
-                if (iter->next == nullptr)
+                if (iter == nullptr || iter->next == nullptr)
                     throw invalid_iterator();
 
                 iter = iter->next;
@@ -342,7 +1174,7 @@ namespace sjtu {
 
 
             const_iterator &operator++() {
-                if (iter->next == nullptr)
+                if (iter == nullptr || iter->next == nullptr)
                     throw invalid_iterator();
                 iter = iter->next;
                 return *this;
@@ -352,7 +1184,7 @@ namespace sjtu {
             const_iterator operator--(int) {
                 const_iterator ret = *this;
 
-                if ((iter->prev)->prev == nullptr)
+                if (iter == nullptr || (iter->prev)->prev == nullptr)
                     throw invalid_iterator();
 
                 iter = iter->prev;
@@ -361,7 +1193,7 @@ namespace sjtu {
 
 
             const_iterator &operator--() {
-                if ((iter->prev)->prev == nullptr)
+                if (iter == nullptr || (iter->prev)->prev == nullptr)
                     throw invalid_iterator();
 
                 iter = iter->prev;
@@ -371,7 +1203,7 @@ namespace sjtu {
 
             value_type &operator*() const {
 
-                return *(iter->val);
+                return static_cast<dataNode *>(iter)->val;
             }
 
             bool operator==(const iterator &rhs) const {
@@ -401,73 +1233,567 @@ namespace sjtu {
 
 
             value_type *operator->() const noexcept {
-                return iter->val;
+                return &(static_cast<dataNode *>(iter)->val);
             }
         };
 
         /**
-         * TODO two constructors
+         * owns an element taken out by extract(), node and all, until insert()
+         * links it into a map with an equal allocator. move-only.
+         * the node has storage of its own, so a handle does not keep anything
+         * of the map it came from alive; one destroyed while still holding its
+         * element frees the node.
          */
-        void buildHashList() {
-            if (hashList != nullptr)
-                delete[] hashList;
-            hashList = new LinkedList<dataNode *>[capacity];
+        class node_type {
+        private:
+            friend class linked_hashmap;
 
-            dataNode *cur;
-            cur = (elemTable.head)->next;
-            while (cur != elemTable.tail) {
-                size_t hashVal = getHash((*(cur->val)).first);
-                size_t idx = hashVal % capacity;
+            dataNode *node;
+            union {
+                Allocator alloc; //alive while node is, so non-assignable allocators work too
+            };
+
+            node_type(dataNode *node, const Allocator &allocator) : node(node) {
+                new(&alloc) Allocator(allocator);
+            }
+
+            void reset() {
+                if (node == nullptr)
+                    return;
+                allocTraits::destroy(alloc, &node->val);
+                node->~dataNode();
+                LinkedList<value_type>::NodePool::giveLoose(node, alloc);
+                alloc.~Allocator();
+                node = nullptr;
+            }
+
+            /**
+             * the element now belongs to a map; forget it without destroying it
+             */
+            dataNode *hand() {
+                dataNode *ret = node;
+                alloc.~Allocator();
+                node = nullptr;
+                return ret;
+            }
+
+        public:
+            typedef Key key_type;
+            typedef T mapped_type;
+            typedef Allocator allocator_type;
+
+            node_type() noexcept : node(nullptr) {}
+
+            node_type(node_type &&other) noexcept : node(other.node) {
+                if (node != nullptr) {
+                    new(&alloc) Allocator(std::move(other.alloc));
+                    other.hand();
+                }
+            }
+
+            node_type &operator=(node_type &&other) noexcept {
+                if (this == &other)
+                    return *this;
+                reset();
+                if (other.node != nullptr) {
+                    new(&alloc) Allocator(std::move(other.alloc));
+                    node = other.node;
+                    other.hand();
+                }
+                return *this;
+            }
+
+            ~node_type() {
+                reset();
+            }
+
+            bool empty() const noexcept {
+                return node == nullptr;
+            }
+
+            explicit operator bool() const noexcept {
+                return node != nullptr;
+            }
+
+            /**
+             * the key may be changed here, before the node is inserted again
+             */
+            Key &key() const {
+                return const_cast<Key &>(node->val.first);
+            }
+
+            T &mapped() const {
+                return node->val.second;
+            }
+
+            allocator_type get_allocator() const {
+                return alloc;
+            }
+
+            void swap(node_type &other) noexcept {
+                node_type tmp(std::move(other));
+                other = std::move(*this);
+                *this = std::move(tmp);
+            }
+        };
+
+        /**
+         * the result of insert(node_type &&): where the key now is, whether the
+         * handle's element was inserted, and the element back if it was not
+         */
+        struct insert_return_type {
+            iterator position;
+            bool inserted;
+            node_type node;
+        };
+
+        /**
+         * enables the overloads taking any K when Hash and Equal are transparent;
+         * K convertible to an iterator keeps picking erase(iterator)
+         */
+        template<class K>
+        using transparentKey = typename std::enable_if<transparent_lookup<Hash, Equal>::value
+                                                       && !std::is_convertible<K, iterator>::value
+                                                       && !std::is_convertible<K, const_iterator>::value, int>::type;
+
+    private:
+        template<class K>
+        dataNode *findNode(const K &key, size_t keyHash) const {
+            dataNode *dataPos = hashTable.findNode(key, keyHash, judgeEqual);
+            if (dataPos == nullptr && oldTable.capacity != 0)
+                dataPos = oldTable.findNode(key, keyHash, judgeEqual);
+            return dataPos;
+        }
+
+        /**
+         * records a hit on dataPos: in access order it moves to the back
+         */
+        void touch(dataNode *dataPos) {
+            if (accessOrder)
+                elemTable.spliceRange(elemTable.tail, dataPos, dataPos->next);
+        }
+
+        /**
+         * how many keys a batched lookup keeps in flight at once
+         */
+        static const size_t batchWidth = 16;
 
-                hashList[idx].pushBack(cur);
+        /**
+         * looks up width (at most batchWidth) keys in three passes: hash every
+         * key and prefetch its home slot, then prefetch the matching nodes,
+         * then compare keys. the cache misses of different keys overlap
+         * instead of being paid one after another.
+         */
+        void probeBatch(const Key *keys, size_t width, dataNode **found) const {
+            size_t keyHash[batchWidth];
+            bool migrating = oldTable.capacity != 0;
+            for (size_t i = 0; i < width; i++) {
+                keyHash[i] = getHash(keys[i]);
+                hashTable.prefetchHome(keyHash[i]);
+                if (migrating)
+                    oldTable.prefetchHome(keyHash[i]);
+            }
+            for (size_t i = 0; i < width; i++) {
+                hashTable.prefetchNode(keyHash[i]);
+                if (migrating)
+                    oldTable.prefetchNode(keyHash[i]);
+            }
+            for (size_t i = 0; i < width; i++)
+                found[i] = findNode(keys[i], keyHash[i]);
+        }
+
+        /**
+         * drops dataPos from whichever table points at it
+         */
+        void unlinkSlot(const dataNode *dataPos) {
+            if (!unlinkPlaced(dataPos))
+                unlinkProbed(dataPos, dataPos->recall(getHash, dataPos->val.first));
+        }
+
+        /**
+         * as above with the key's hash at hand, for a node whose key may have
+         * been moved from already
+         */
+        void unlinkSlot(const dataNode *dataPos, size_t keyHash) {
+            if (!unlinkPlaced(dataPos))
+                unlinkProbed(dataPos, keyHash);
+        }
+
+        bool unlinkPlaced(const dataNode *dataPos) {
+            if (hashTable.placedAt(dataPos)) {
+                hashTable.remove(dataPos->slot);
+                return true;
+            }
+            if (oldTable.placedAt(dataPos)) {
+                oldTable.remove(dataPos->slot);
+                return true;
+            }
+            return false;
+        }
+
+        //the probe compares node addresses only, never keys
+        void unlinkProbed(const dataNode *dataPos, size_t keyHash) {
+            size_t idx = hashTable.probeFor(dataPos, keyHash);
+            if (idx != hashTable.capacity)
+                hashTable.remove(idx);
+            else
+                oldTable.remove(oldTable.probeFor(dataPos, keyHash));
+        }
+
+        /**
+         * moves entries of oldTable into hashTable, at most steps slots at a time.
+         * a drained slot is emptied by backward shift, which may pull the next
+         * entry of its cluster into it; the slot is left behind only once it
+         * stays empty, so oldTable remains a valid table for lookups throughout.
+         */
+        void migrate(size_t steps) {
+            while (steps > 0 && migratePos < oldTable.capacity) {
+                steps--;
+                Bucket &bucket = oldTable.slots[migratePos];
+                if (bucket.node == nullptr) {
+                    migratePos++;
+                    continue;
+                }
+                hashTable.place(bucket.node, bucket.hashVal);
+                oldTable.remove(migratePos);
+            }
+            if (migratePos == oldTable.capacity) {
+                oldTable.release(elemTable.alloc);
+                migratePos = 0;
+            }
+        }
+
+        void finishRehash() {
+            migrate(size_t(-1));
+        }
+
+        /**
+         * the steps one insert or erase drains: at least migrateStep, and
+         * enough that oldTable is gone before the table is due to grow or
+         * shrink again. every slot left and every entry costs a step, so
+         * the work is bounded by the slots left plus size(); spread over the
+         * operations left, each one does about the same share.
+         */
+        size_t drainStep() const {
+            size_t work = oldTable.capacity - migratePos + totLength;
+            size_t growAt = static_cast<size_t>(policy.grow_load * hashTable.capacity);
+            size_t room = growAt > totLength ? growAt - totLength : 0;
+            if (policy.shrink) {
+                size_t shrinkAt = static_cast<size_t>(policy.shrink_load * hashTable.capacity);
+                size_t shrinkRoom = totLength > shrinkAt ? totLength - shrinkAt : 0;
+                if (shrinkRoom < room)
+                    room = shrinkRoom;
+            }
+            size_t steps = work / (room + 1) + 1;
+            return steps > migrateStep ? steps : migrateStep;
+        }
+
+        /**
+         * switches to a table of newCapacity slots. with incremental rehashing
+         * the old table is kept and drained a few slots per operation,
+         * otherwise it is drained right away.
+         * the new table is allocated before anything changes, so the index
+         * stays as it was if that throws.
+         */
+        void rehashTo(size_t newCapacity) {
+            BucketTable fresh;
+            fresh.allocate(newCapacity, elemTable.alloc);
+            if (oldTable.capacity != 0)
+                finishRehash();
+
+            oldTable = hashTable;
+            migratePos = 0;
+            hashTable = fresh;
+
+            if (migrateStep == 0)
+                finishRehash();
+            else
+                migrate(drainStep());
+        }
+
+        /**
+         * indexes every node of elemTable in a new table of newCapacity slots,
+         * which replaces both tables only once it has been allocated
+         */
+        void buildHashTable(size_t newCapacity) {
+            BucketTable fresh;
+            fresh.allocate(newCapacity, elemTable.alloc);
+            hashTable.release(elemTable.alloc);
+            oldTable.release(elemTable.alloc);
+            migratePos = 0;
+            hashTable = fresh;
+            if (elemTable.empty())
+                return;
+
+            linkNode *cur;
+            cur = (elemTable.head)->next;
+            while (cur != elemTable.tail) {
+                dataNode *dataPos = static_cast<dataNode *>(cur);
+                hashTable.place(dataPos, dataPos->recall(getHash, dataPos->val.first));
                 cur = cur->next;
             }
 
             return;
         }
 
-        void halfSize(){
-            if(capacity/2 == 0)
-                return ;
-            capacity/=2;
-            delete [] hashList;
+        /**
+         * grow_load must leave the table some empty slots, and halving the
+         * table at shrink_load must not land it above grow_load again
+         */
+        static void checkPolicy(const resize_policy &resizePolicy) {
+            if (!(resizePolicy.grow_load > 0 && resizePolicy.grow_load < 1))
+                throw runtime_error();
+            if (resizePolicy.shrink && !(resizePolicy.shrink_load >= 0 && resizePolicy.shrink_load * 2 < resizePolicy.grow_load))
+                throw runtime_error();
+        }
+
+        /**
+         * shrinks the table in one go to where halving it while it stays
+         * under shrink_load would land. an empty map gives both tables back,
+         * unless min_buckets keeps it above the initial size.
+         */
+        void shrinkTable() {
+            if (totLength == 0 && policy.min_buckets <= initCapacity) {
+                hashTable.release(elemTable.alloc);
+                oldTable.release(elemTable.alloc);
+                migratePos = 0;
+                return;
+            }
+
+            size_t newCapacity = hashTable.capacity;
+            while (totLength < policy.shrink_load * newCapacity
+                   && newCapacity / 2 >= initCapacity && newCapacity / 2 >= policy.min_buckets) {
+                size_t half = indexPolicy::round_size(newCapacity / 2);
+                if (half >= newCapacity)
+                    break;
+                newCapacity = half;
+            }
+            if (newCapacity != hashTable.capacity)
+                rehashTo(newCapacity);
+        }
+
+        /**
+         * a table size indexPolicy accepts, at least initCapacity, that holds
+         * n entries without crossing the grow threshold
+         */
+        size_t bucketsFor(size_t n) const {
+            size_t newCapacity = indexPolicy::round_size(initCapacity);
+            while (n > policy.grow_load * newCapacity)
+                newCapacity = indexPolicy::round_size(newCapacity * 2);
+            return newCapacity;
+        }
+
+        /**
+         * grows the table, or drains the old one a bit, ahead of one more element
+         */
+        void makeRoom() {
+            if (totLength + 1 > policy.grow_load * hashTable.capacity)
+                doubleSize();
+            else if (oldTable.capacity != 0)
+                migrate(drainStep());
+        }
 
-            hashList = new LinkedList<dataNode * > [capacity];
+        /**
+         * counts and indexes a node just linked into elemTable
+         */
+        iterator settle(dataNode *dataPos, size_t keyHash) {
+            totLength++;
+            dataPos->keep(keyHash);
+            hashTable.place(dataPos, keyHash);
+            return iterator(dataPos, elemTable.head);
+        }
 
-            dataNode  *cur = (elemTable.head)->next;
+        /**
+         * appends a new element built in place from args; its key must be absent
+         */
+        template<class... Args>
+        iterator emplaceNew(size_t keyHash, Args &&... args) {
+            makeRoom();
+            return settle(elemTable.emplaceBack(std::forward<Args>(args)...), keyHash);
+        }
 
-            while(cur != elemTable.tail){
-                size_t hashVal = getHash((*(cur->val)).first);
-                size_t idx = hashVal % capacity;
+        /**
+         * erases the element with key, returning 1, or 0 if there is none
+         */
+        template<class K>
+        size_t eraseKey(const K &key, size_t keyHash) {
+            dataNode *dataPos = findNode(key, keyHash);
+            if (dataPos == nullptr)
+                return 0;
+            unlinkSlot(dataPos);
+            elemTable.erase(dataPos);
+            settleRemoval();
+            return 1;
+        }
 
-                hashList[idx].pushBack(cur);
-                cur = cur->next;
+        /**
+         * moves the elements [first, last) of other in front of pos, keeping
+         * their order and skipping those whose key is already here; the
+         * skipped ones stay in other. only part of other's pool would go
+         * along, so unlike merge() each element but one from a handle is
+         * moved into a node of this map's pool and its old node goes back to
+         * other's pool. other's table is not shrunk meanwhile.
+         * everything that can throw runs before the element leaves other,
+         * so an exception leaves it in exactly one of the maps.
+         * returns how many elements moved.
+         */
+        size_t transferRange(linkNode *pos, linked_hashmap &other, linkNode *first, linkNode *last) {
+            size_t moved = 0;
+            while (first != last) {
+                dataNode *dataPos = static_cast<dataNode *>(first);
+                first = first->next;
+
+                size_t keyHash = dataPos->recall(getHash, dataPos->val.first);
+                if (findNode(dataPos->val.first, keyHash) != nullptr)
+                    continue;
+
+                if (elemTable.head == nullptr)
+                    elemTable.initSentinels();
+                makeRoom();
+                dataNode *moving = dataPos->loose ? dataPos : elemTable.relocate(dataPos, false);
+
+                other.unlinkSlot(dataPos, keyHash);
+                other.elemTable.remove(dataPos);
+                if (moving == dataPos)
+                    other.elemTable.looseCount--;
+                else
+                    other.elemTable.recycle(dataPos);
+                other.totLength--;
+                if (other.oldTable.capacity != 0)
+                    other.migrate(other.drainStep());
+
+                settle(elemTable.linkBefore(pos, moving), keyHash);
+                moved++;
             }
+            return moved;
+        }
 
-            return ;
+        /**
+         * puts own, an unlinked copy of dataPos, in its place in the order
+         * and the index, and frees dataPos; returns own
+         */
+        dataNode *replaceNode(dataNode *dataPos, dataNode *own, size_t keyHash) {
+            unlinkSlot(dataPos, keyHash);
+            elemTable.linkBefore(dataPos, own);
+            elemTable.erase(dataPos);
+            hashTable.place(own, keyHash);
+            return own;
+        }
+
+        /**
+         * counts one element less, drains the old table a bit and shrinks
+         * the table once it falls under shrink_load. mid-rehash the shrink
+         * waits for the drain to end, which drainStep() paces to end in time,
+         * unless the map is empty and both tables can simply go.
+         */
+        void settleRemoval() {
+            totLength--;
+            if (oldTable.capacity != 0)
+                migrate(drainStep());
+            if (policy.shrink && (oldTable.capacity == 0 || totLength == 0)
+                && totLength < policy.shrink_load * hashTable.capacity)
+                shrinkTable();
         }
+
         void doubleSize() {
-            capacity *= 2;
-            buildHashList();
+            rehashTo(indexPolicy::round_size(hashTable.capacity == 0 ? initCapacity : hashTable.capacity * 2));
+        }
+
+        void moveAssign(linked_hashmap &other, std::true_type) {
+            takeOver(other, std::true_type());
         }
 
+        /**
+         * only compiled without propagation, so mapped types that cannot be
+         * copied still move-assign
+         */
+        void moveAssign(linked_hashmap &other, std::false_type) {
+            if (elemTable.alloc == other.elemTable.alloc) {
+                takeOver(other, std::false_type());
+                return;
+            }
+
+            clear();
+            getHash = other.getHash;
+            judgeEqual = other.judgeEqual;
+            policy = other.policy;
+            migrateStep = other.migrateStep;
+            accessOrder = other.accessOrder;
+            if (!other.elemTable.empty())
+                for (linkNode *cur = other.elemTable.head->next; cur != other.elemTable.tail; cur = cur->next) {
+                    value_type &val = static_cast<dataNode *>(cur)->val;
+                    try_emplace(val.first, std::move(val.second));
+                }
+            other.clear();
+        }
+
+        template<class Propagate>
+        void takeOver(linked_hashmap &other, Propagate propagate) {
+            elemTable.clear();
+            hashTable.release(elemTable.alloc);
+            oldTable.release(elemTable.alloc);
+
+            getHash = std::move(other.getHash);
+            judgeEqual = std::move(other.judgeEqual);
+            hashTable = other.hashTable;
+            oldTable = other.oldTable;
+            migratePos = other.migratePos;
+            migrateStep = other.migrateStep;
+            policy = other.policy;
+            totLength = other.totLength;
+            accessOrder = other.accessOrder;
+            //other keeps our empty sentinels, and the allocator they came from
+            elemTable.swap(other.elemTable, propagate);
+
+            other.hashTable = BucketTable();
+            other.oldTable = BucketTable();
+            other.migratePos = 0;
+            other.totLength = 0;
+        }
+
+    public:
+        /**
+         * TODO two constructors
+         */
+        /**
+         * nothing is allocated until the first insertion
+         */
         linked_hashmap() {
-            loadFactor = 1<<5 ;
-            capacity = 1 << 15;
             totLength = 0;
-            hashList = new LinkedList<dataNode *>[capacity];
+            migratePos = 0;
+            migrateStep = 0;
+            accessOrder = false;
         }
 
-        linked_hashmap(const linked_hashmap &other) {
-            loadFactor = other.loadFactor;
-            capacity = other.capacity;
+        explicit linked_hashmap(const Allocator &alloc) : elemTable(alloc) {
+            totLength = 0;
+            migratePos = 0;
+            migrateStep = 0;
+            accessOrder = false;
+        }
 
-            totLength = other.totLength;
+        explicit linked_hashmap(const resize_policy &resizePolicy, const Allocator &alloc = Allocator())
+                : elemTable(alloc) {
+            checkPolicy(resizePolicy);
+            policy = resizePolicy;
+            totLength = 0;
+            migratePos = 0;
+            migrateStep = 0;
+            accessOrder = false;
+        }
+
+        linked_hashmap(const linked_hashmap &other)
+                : linked_hashmap(other, allocTraits::select_on_container_copy_construction(other.elemTable.alloc)) {}
+
+        linked_hashmap(const linked_hashmap &other, const Allocator &alloc) : elemTable(other.elemTable, alloc) {
+            policy = other.policy;
+            migratePos = 0;
+            migrateStep = other.migrateStep;
+            accessOrder = other.accessOrder;
 
+            totLength = other.totLength;
 
-            hashList = nullptr;
-            elemTable = other.elemTable;
-            buildHashList();
+            buildHashTable(other.totLength == 0 ? 0 : other.hashTable.capacity);
 
         }
 
@@ -478,29 +1804,83 @@ namespace sjtu {
             if (this == &other)
                 return *this;
 
-            delete[] hashList;
+            //the tables go back to the allocator that handed them out,
+            //before elemTable possibly takes over other's allocator
             elemTable.clear();
+            hashTable.release(elemTable.alloc);
+            oldTable.release(elemTable.alloc);
+            migratePos = 0;
+            totLength = 0;
 
-            capacity = other.capacity;
-            loadFactor = other.loadFactor;
-
+            policy = other.policy;
+            migrateStep = other.migrateStep;
+            accessOrder = other.accessOrder;
+
+            //if copying throws, the map is left empty rather than half indexed
+            try {
+                elemTable = other.elemTable;
+                buildHashTable(other.totLength == 0 ? 0 : other.hashTable.capacity);
+            } catch (...) {
+                elemTable.clear();
+                throw;
+            }
             totLength = other.totLength;
 
-            hashList = nullptr;
-
-            elemTable = other.elemTable;
+            return *this;
+        }
 
-            buildHashList();
+        /**
+         * takes over other's nodes, sentinels and tables in O(1); other is left empty
+         */
+        linked_hashmap(linked_hashmap &&other) noexcept
+                : getHash(std::move(other.getHash)), judgeEqual(std::move(other.judgeEqual)),
+                  hashTable(other.hashTable), oldTable(other.oldTable),
+                  migratePos(other.migratePos), migrateStep(other.migrateStep),
+                  elemTable(std::move(other.elemTable)), policy(other.policy), totLength(other.totLength),
+                  accessOrder(other.accessOrder) {
+            other.hashTable = BucketTable();
+            other.oldTable = BucketTable();
+            other.migratePos = 0;
+            other.totLength = 0;
+        }
 
+        /**
+         * steals other's contents like the move constructor, unless the
+         * allocators differ and may not propagate; then the elements are
+         * moved over one by one and other is left empty
+         */
+        linked_hashmap &operator=(linked_hashmap &&other)
+        noexcept(allocTraits::propagate_on_container_move_assignment::value) {
+            if (this == &other)
+                return *this;
+            moveAssign(other, typename allocTraits::propagate_on_container_move_assignment());
             return *this;
         }
 
+        /**
+         * exchanges the contents in O(1); iterators keep pointing at the same
+         * elements, now in the other map
+         */
+        void swap(linked_hashmap &other) noexcept {
+            using std::swap;
+            swap(getHash, other.getHash);
+            swap(judgeEqual, other.judgeEqual);
+            swap(hashTable, other.hashTable);
+            swap(oldTable, other.oldTable);
+            swap(migratePos, other.migratePos);
+            swap(migrateStep, other.migrateStep);
+            swap(policy, other.policy);
+            swap(totLength, other.totLength);
+            swap(accessOrder, other.accessOrder);
+            elemTable.swap(other.elemTable, typename allocTraits::propagate_on_container_swap());
+        }
+
         /**
          * TODO Destructors
          */
         ~linked_hashmap() {
-            delete[] hashList;
-            hashList = nullptr;
+            hashTable.release(elemTable.alloc);
+            oldTable.release(elemTable.alloc);
 //            elemTable.clear();
         }
 
@@ -515,9 +1895,9 @@ namespace sjtu {
             if (dataIter == end())
                 throw index_out_of_bound();
 
-            dataNode *dataPos = dataIter.iter;
+            dataNode *dataPos = static_cast<dataNode *>(dataIter.iter);
 
-            return (*(dataPos->val)).second;
+            return dataPos->val.second;
         }
 
         const T &at(const Key &key) const {
@@ -526,47 +1906,140 @@ namespace sjtu {
             if (dataIter == cend())
                 throw index_out_of_bound();
 
-            const dataNode *dataPos = dataIter.iter;
+            const dataNode *dataPos = static_cast<const dataNode *>(dataIter.iter);
 
-            return (*(dataPos->val)).second;
+            return dataPos->val.second;
 
         }
 
         /**
-         * TODO
-         * access specified element
-         * Returns a reference to the value that is mapped to a key equivalent to key,
-         *   performing an insertion if such key does not already exist.
+         * as above for any key type the transparent Hash and Equal accept;
+         * key is never converted to Key
          */
-        T &operator[](const Key &key) {
-            size_t keyHash = getHash(key);
-            size_t idx = keyHash % capacity;
+        template<class K, transparentKey<K> = 0>
+        T &at(const K &key) {
+            dataNode *dataPos = findNode(key, getHash(key));
+            if (dataPos == nullptr)
+                throw index_out_of_bound();
+            touch(dataPos);
+            return dataPos->val.second;
+        }
 
-            ptrNode *cur = (hashList[idx].head)->next;
-            while (cur != hashList[idx].tail) {
-                dataNode *dataPos = *(cur->val);
-                if (judgeEqual(key, (*(dataPos->val)).first))
-                    return (*(dataPos->val)).second;
+        template<class K, transparentKey<K> = 0>
+        const T &at(const K &key) const {
+            const dataNode *dataPos = findNode(key, getHash(key));
+            if (dataPos == nullptr)
+                throw index_out_of_bound();
+            return dataPos->val.second;
+        }
 
-                cur = cur->next;
-            }
+        /**
+         * like at(), but a missing key gives nullptr instead of an exception,
+         * so a miss costs no more than a hit
+         */
+        T *get_if(const Key &key) {
+            dataNode *dataPos = findNode(key, getHash(key));
+            if (dataPos == nullptr)
+                return nullptr;
+            touch(dataPos);
+            return &dataPos->val.second;
+        }
 
+        const T *get_if(const Key &key) const {
+            const dataNode *dataPos = findNode(key, getHash(key));
+            return dataPos == nullptr ? nullptr : &dataPos->val.second;
+        }
 
-            value_type newIns(key, T());
+        template<class K, transparentKey<K> = 0>
+        T *get_if(const K &key) {
+            dataNode *dataPos = findNode(key, getHash(key));
+            if (dataPos == nullptr)
+                return nullptr;
+            touch(dataPos);
+            return &dataPos->val.second;
+        }
 
-            totLength++;
-            if (totLength >= loadFactor * capacity)
-                doubleSize();
+        template<class K, transparentKey<K> = 0>
+        const T *get_if(const K &key) const {
+            const dataNode *dataPos = findNode(key, getHash(key));
+            return dataPos == nullptr ? nullptr : &dataPos->val.second;
+        }
 
-            idx = keyHash % capacity;
+#ifdef SJTU_LINKEDHASHMAP_OPTIONAL
+        /**
+         * get_if() as an optional reference, empty when key is missing
+         */
+        std::optional<std::reference_wrapper<T> > try_at(const Key &key) {
+            T *found = get_if(key);
+            if (found == nullptr)
+                return std::nullopt;
+            return std::ref(*found);
+        }
 
+        std::optional<std::reference_wrapper<const T> > try_at(const Key &key) const {
+            const T *found = get_if(key);
+            if (found == nullptr)
+                return std::nullopt;
+            return std::cref(*found);
+        }
 
-            dataNode *dataPos = elemTable.pushBack(newIns);
-            hashList[idx].pushBack(dataPos);
+        template<class K, transparentKey<K> = 0>
+        std::optional<std::reference_wrapper<T> > try_at(const K &key) {
+            T *found = get_if(key);
+            if (found == nullptr)
+                return std::nullopt;
+            return std::ref(*found);
+        }
 
-            return (*(dataPos->val)).second;
+        template<class K, transparentKey<K> = 0>
+        std::optional<std::reference_wrapper<const T> > try_at(const K &key) const {
+            const T *found = get_if(key);
+            if (found == nullptr)
+                return std::nullopt;
+            return std::cref(*found);
+        }
+#endif
 
+        /**
+         * TODO
+         * access specified element
+         * Returns a reference to the value that is mapped to a key equivalent to key,
+         *   performing an insertion if such key does not already exist.
+         */
+        T &operator[](const Key &key) {
+            return subscript_hashed(key, getHash(key));
+        }
+
+        /**
+         * as above; a new element takes key over by move
+         */
+        T &operator[](Key &&key) {
+            return subscript_hashed(std::move(key), getHash(key));
+        }
+
+        /**
+         * operator[] for a key whose hash the caller already has.
+         * like every *_hashed member, keyHash must be what Hash gives for key;
+         * any other value makes the map lose track of the element.
+         */
+        T &subscript_hashed(const Key &key, size_t keyHash) {
+            dataNode *dataPos = findNode(key, keyHash);
+            if (dataPos != nullptr) {
+                touch(dataPos);
+                return dataPos->val.second;
+            }
+
+            return emplaceNew(keyHash, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>())->second;
+        }
+
+        T &subscript_hashed(Key &&key, size_t keyHash) {
+            dataNode *dataPos = findNode(key, keyHash);
+            if (dataPos != nullptr) {
+                touch(dataPos);
+                return dataPos->val.second;
+            }
 
+            return emplaceNew(keyHash, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::tuple<>())->second;
         }
 
         /**
@@ -576,8 +2049,8 @@ namespace sjtu {
             const_iterator pos = find(key);
 
             if (pos != cend()) {
-                const dataNode *dataPos = pos.iter;
-                return (*(dataPos->val)).second;
+                const dataNode *dataPos = static_cast<const dataNode *>(pos.iter);
+                return dataPos->val.second;
             } else
                 throw index_out_of_bound();
 
@@ -588,10 +2061,14 @@ namespace sjtu {
          * return a iterator to the beginning
          */
         iterator begin() {
+            if (elemTable.head == nullptr)
+                return end();
             return iterator((elemTable.head)->next, elemTable.head);
         }
 
         const_iterator cbegin() const {
+            if (elemTable.head == nullptr)
+                return cend();
             const_iterator ret((elemTable.head)->next, elemTable.head);
             return ret;
         }
@@ -627,12 +2104,18 @@ namespace sjtu {
             return totLength;
         }
 
+        allocator_type get_allocator() const {
+            return elemTable.alloc;
+        }
+
         /**
          * clears the contents
          */
         void clear() {
-            for (int i = 0; i < capacity; i++)
-                hashList[i].clear();
+            for (size_t i = 0; i < hashTable.capacity; i++)
+                hashTable.slots[i].node = nullptr;
+            oldTable.release(elemTable.alloc);
+            migratePos = 0;
             elemTable.clear();
             totLength = 0;
         }
@@ -644,26 +2127,121 @@ namespace sjtu {
          *   the second one is true if insert successfully, or false.
          */
         pair<iterator, bool> insert(const value_type &value) {
-            iterator pos = find(value.first);
-            if (pos != end()) {
-                pair<iterator, bool> ret(pos, false);
+            return insert_hashed(value, getHash(value.first));
+        }
+
+        /**
+         * as above, moving value into the new node; value is left alone if
+         * its key is already present
+         */
+        pair<iterator, bool> insert(value_type &&value) {
+            return insert_hashed(std::move(value), getHash(value.first));
+        }
+
+        /**
+         * insert() with keyHash, the precomputed hash of value.first
+         */
+        pair<iterator, bool> insert_hashed(const value_type &value, size_t keyHash) {
+            dataNode *dataPos = findNode(value.first, keyHash);
+            if (dataPos != nullptr) {
+                pair<iterator, bool> ret(iterator(dataPos, elemTable.head), false);
                 return ret;
             }
 
-            totLength++;
-            if (totLength >= capacity * loadFactor)
-                doubleSize();
+            return pair<iterator, bool>(emplaceNew(keyHash, value), true);
+        }
 
-            dataNode *dataPos = elemTable.pushBack(value);
+        pair<iterator, bool> insert_hashed(value_type &&value, size_t keyHash) {
+            dataNode *dataPos = findNode(value.first, keyHash);
+            if (dataPos != nullptr)
+                return pair<iterator, bool>(iterator(dataPos, elemTable.head), false);
+
+            return pair<iterator, bool>(emplaceNew(keyHash, std::move(value)), true);
+        }
 
-            size_t keyHash = getHash(value.first);
-            size_t idx = keyHash % capacity;
+        /**
+         * constructs the element in its node from args, then inserts it
+         * unless its key is already present (the new node is dropped then)
+         */
+        template<class... Args>
+        pair<iterator, bool> emplace(Args &&... args) {
+            dataNode *newIns = elemTable.makeNode(std::forward<Args>(args)...);
+            size_t keyHash;
+            dataNode *dataPos;
+            try {
+                keyHash = getHash(newIns->val.first);
+                dataPos = findNode(newIns->val.first, keyHash);
+                if (dataPos == nullptr)
+                    makeRoom();
+            } catch (...) {
+                elemTable.dropNode(newIns);
+                throw;
+            }
+            if (dataPos != nullptr) {
+                elemTable.dropNode(newIns);
+                return pair<iterator, bool>(iterator(dataPos, elemTable.head), false);
+            }
 
-            hashList[idx].pushBack(dataPos);
+            elemTable.linkBack(newIns);
+            return pair<iterator, bool>(settle(newIns, keyHash), true);
+        }
 
-            iterator ret(dataPos, elemTable.head);
+        /**
+         * if key is absent, inserts (key, T(args...)) built in place;
+         * otherwise leaves the map and args untouched
+         */
+        template<class... Args>
+        pair<iterator, bool> try_emplace(const Key &key, Args &&... args) {
+            size_t keyHash = getHash(key);
+            dataNode *dataPos = findNode(key, keyHash);
+            if (dataPos != nullptr)
+                return pair<iterator, bool>(iterator(dataPos, elemTable.head), false);
 
-            return pair<iterator, bool>(ret, true);
+            return pair<iterator, bool>(emplaceNew(keyHash, std::piecewise_construct, std::forward_as_tuple(key),
+                                                   std::forward_as_tuple(std::forward<Args>(args)...)), true);
+        }
+
+        template<class... Args>
+        pair<iterator, bool> try_emplace(Key &&key, Args &&... args) {
+            size_t keyHash = getHash(key);
+            dataNode *dataPos = findNode(key, keyHash);
+            if (dataPos != nullptr)
+                return pair<iterator, bool>(iterator(dataPos, elemTable.head), false);
+
+            return pair<iterator, bool>(emplaceNew(keyHash, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                                   std::forward_as_tuple(std::forward<Args>(args)...)), true);
+        }
+
+        /**
+         * assigns obj to the value of key, inserting (key, obj) if key is absent.
+         * the second of the result is true if an insertion took place.
+         */
+        template<class M>
+        pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+            size_t keyHash = getHash(key);
+            dataNode *dataPos = findNode(key, keyHash);
+            if (dataPos != nullptr) {
+                dataPos->val.second = std::forward<M>(obj);
+                touch(dataPos);
+                return pair<iterator, bool>(iterator(dataPos, elemTable.head), false);
+            }
+
+            return pair<iterator, bool>(emplaceNew(keyHash, std::piecewise_construct, std::forward_as_tuple(key),
+                                                   std::forward_as_tuple(std::forward<M>(obj))), true);
+        }
+
+        template<class M>
+        pair<iterator, bool> insert_or_assign(Key &&key, M &&obj) {
+            size_t keyHash = getHash(key);
+            dataNode *dataPos = findNode(key, keyHash);
+            if (dataPos != nullptr) {
+                dataPos->val.second = std::forward<M>(obj);
+                touch(dataPos);
+                return pair<iterator, bool>(iterator(dataPos, elemTable.head), false);
+            }
+
+            return pair<iterator, bool>(emplaceNew(keyHash, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                                   std::forward_as_tuple(std::forward<M>(obj))), true);
         }
 
         /**
@@ -679,60 +2257,231 @@ namespace sjtu {
             if (pos.identity != elemTable.head)
                 throw index_out_of_bound();
 
-            totLength--;
-            if(totLength < capacity*loadFactor / 2)
-                halfSize();
+            dataNode *dataPos = static_cast<dataNode *>(pos.iter);
 
-            dataNode *dataPos = pos.iter;
-            value_type data = *(dataPos->val);
+            unlinkSlot(dataPos);
 
-            size_t keyHash = getHash(data.first);
-            size_t idx = keyHash % capacity;
+            elemTable.erase(dataPos);
 
-            ptrNode *cur = (hashList[idx].head)->next;
-            while (cur != hashList[idx].tail) {
-                if (dataPos == *(cur->val)) {
-                    hashList[idx].erase(cur);
-                    break;
-                }
-                cur = cur->next;
-            }
+            settleRemoval();
+        }
 
-            elemTable.erase(dataPos);
+        /**
+         * erases the element with key, if any, and returns how many were erased
+         */
+        size_t erase(const Key &key) {
+            return erase_hashed(key, getHash(key));
         }
 
         /**
-         * Returns the number of elements with key
-         *   that compares equivalent to the specified argument,
-         *   which is either 1 or 0
-         *     since this container does not allow duplicates.
+         * erase(key) with keyHash, the precomputed hash of key
          */
+        size_t erase_hashed(const Key &key, size_t keyHash) {
+            return eraseKey(key, keyHash);
+        }
 
-        bool checkExistence(const Key KV) const {
-            size_t keyHash = getHash(KV);
-            size_t idx = keyHash % capacity;
+        /**
+         * as above for any key type the transparent Hash and Equal accept
+         */
+        template<class K, transparentKey<K> = 0>
+        size_t erase(const K &key) {
+            return eraseKey(key, getHash(key));
+        }
 
-            ptrNode *cur = (hashList[idx].head)->next;
-            while (cur != hashList[idx].tail) {
-                dataNode *tmp = *(cur->val);
+        /**
+         * unlinks the element at pos and hands it over to a node handle.
+         * the element is moved into a node of its own first, unless it came
+         * in through a handle and already has one, so that the handle does
+         * not depend on this map's storage.
+         * throws like erase() if pos is end() or belongs to another map.
+         */
+        node_type extract(iterator pos) {
+            if (pos == end())
+                throw index_out_of_bound();
 
-                value_type data = *(tmp->val);
-                if (judgeEqual(KV, data.first))
-                    return true;
+            if (pos.identity != elemTable.head)
+                throw index_out_of_bound();
 
+            dataNode *dataPos = static_cast<dataNode *>(pos.iter);
+            if (dataPos->loose) {
+                unlinkSlot(dataPos);
+                elemTable.detach(dataPos);
+                settleRemoval();
+                return node_type(dataPos, elemTable.alloc);
+            }
+
+            size_t keyHash = dataPos->recall(getHash, dataPos->val.first);
+            node_type nh(elemTable.relocate(dataPos, true), elemTable.alloc);
+            unlinkSlot(dataPos, keyHash);
+            elemTable.erase(dataPos);
+            settleRemoval();
+            return nh;
+        }
+
+        /**
+         * as above for the element with key, or an empty handle if there is none
+         */
+        node_type extract(const Key &key) {
+            dataNode *dataPos = findNode(key, getHash(key));
+            if (dataPos == nullptr)
+                return node_type();
+            return extract(iterator(dataPos, elemTable.head));
+        }
 
+        /**
+         * moves every element of source whose key is not present here to the
+         * end of this map, in source's order, by relinking its node: values
+         * are neither copied nor moved, and pointers and references to them
+         * stay valid. source's node storage comes along with them.
+         * elements with a colliding key stay in source, each moved into a
+         * node of its own first, as source keeps no storage. the allocators
+         * must compare equal. beyond those nodes, only growing this map's
+         * table allocates; reserve() beforehand avoids that.
+         * everything that can throw runs before the first element moves.
+         */
+        void merge(linked_hashmap &source) {
+            if (&source == this || source.elemTable.empty())
+                return;
+
+            size_t moving = 0;
+            for (linkNode *cur = source.elemTable.head->next; cur != source.elemTable.tail; cur = cur->next) {
+                dataNode *dataPos = static_cast<dataNode *>(cur);
+                size_t keyHash = dataPos->recall(getHash, dataPos->val.first);
+                if (findNode(dataPos->val.first, keyHash) == nullptr)
+                    moving++;
+                else if (!dataPos->loose)
+                    cur = source.replaceNode(dataPos, source.elemTable.relocate(dataPos, true), keyHash);
+            }
+            if (elemTable.head == nullptr)
+                elemTable.initSentinels();
+            size_t newCapacity = bucketsFor(totLength + moving);
+            if (newCapacity > hashTable.capacity)
+                rehashTo(newCapacity);
+
+            linkNode *cur = source.elemTable.head->next;
+            while (cur != source.elemTable.tail) {
+                dataNode *dataPos = static_cast<dataNode *>(cur);
                 cur = cur->next;
+                size_t keyHash = dataPos->recall(getHash, dataPos->val.first);
+                if (findNode(dataPos->val.first, keyHash) != nullptr)
+                    continue;
+
+                source.unlinkSlot(dataPos, keyHash);
+                source.elemTable.remove(dataPos);
+                if (dataPos->loose)
+                    source.elemTable.looseCount--;
+                source.totLength--;
+                settle(elemTable.linkBefore(nullptr, dataPos), keyHash);
             }
+            elemTable.pool.absorb(source.elemTable.pool);
+        }
 
-            return false;
+        void merge(linked_hashmap &&source) {
+            merge(source);
         }
 
-        size_t count(const Key &key) const {
-            if (checkExistence(key))
-                return 1;
-            else {
+        /**
+         * moves the elements [first, last) of other in front of pos in the
+         * insertion order. from another map, elements whose key is already
+         * present here stay in other, and the others are moved into nodes of
+         * this map (copied where moving could throw), so iterators and
+         * references to them are invalidated; only merge() relinks nodes
+         * between maps. the allocators must compare equal. within this map
+         * (&other == this) the nodes are relinked and only the order
+         * changes; pos must not lie strictly inside [first, last).
+         * returns how many elements moved.
+         * throw index_out_of_bound if pos or the range belong to other maps.
+         */
+        size_t splice(iterator pos, linked_hashmap &other, iterator first, iterator last) {
+            if (pos.identity != elemTable.head || first.identity != other.elemTable.head
+                || last.identity != other.elemTable.head)
+                throw index_out_of_bound();
+            if (first == last)
                 return 0;
+
+            if (&other == this) {
+                size_t moved = 0;
+                for (linkNode *cur = first.iter; cur != last.iter; cur = cur->next)
+                    moved++;
+                elemTable.spliceRange(pos.iter, first.iter, last.iter);
+                return moved;
             }
+            return transferRange(pos.iter, other, first.iter, last.iter);
+        }
+
+        /**
+         * relinks the element at pos to the end of the order in O(1), without
+         * touching the index; iterators stay valid.
+         * throws like erase() if pos is end() or belongs to another map.
+         */
+        void move_to_back(iterator pos) {
+            if (pos == end() || pos.identity != elemTable.head)
+                throw index_out_of_bound();
+            elemTable.spliceRange(elemTable.tail, pos.iter, pos.iter->next);
+        }
+
+        /**
+         * as above, relinking the element to the front
+         */
+        void move_to_front(iterator pos) {
+            if (pos == end() || pos.identity != elemTable.head)
+                throw index_out_of_bound();
+            elemTable.spliceRange(elemTable.head->next, pos.iter, pos.iter->next);
+        }
+
+        /**
+         * links the handle's node in at the end of the insertion order, without
+         * allocating or copying, unless an element with an equal key is
+         * present; then the handle is passed back in the result.
+         * throws runtime_error, leaving both untouched, if the handle's
+         * allocator does not compare equal to get_allocator().
+         */
+        insert_return_type insert(node_type &&nh) {
+            if (nh.empty())
+                return insert_return_type{end(), false, node_type()};
+            if (nh.alloc != elemTable.alloc)
+                throw runtime_error();
+
+            const Key &key = nh.node->val.first;
+            size_t keyHash = getHash(key);
+            dataNode *dataPos = findNode(key, keyHash);
+            if (dataPos != nullptr)
+                return insert_return_type{iterator(dataPos, elemTable.head), false, std::move(nh)};
+
+            makeRoom();
+            elemTable.linkBefore(nullptr, nh.node);
+            return insert_return_type{settle(nh.hand(), keyHash), true, node_type()};
+        }
+
+        /**
+         * Returns the number of elements with key
+         *   that compares equivalent to the specified argument,
+         *   which is either 1 or 0
+         *     since this container does not allow duplicates.
+         * the probe is find()'s: it compares keys in place and copies nothing.
+         */
+        size_t count(const Key &key) const {
+            return count_hashed(key, getHash(key));
+        }
+
+        /**
+         * as above for any key type the transparent Hash and Equal accept
+         */
+        template<class K, transparentKey<K> = 0>
+        size_t count(const K &key) const {
+            return findNode(key, getHash(key)) == nullptr ? 0 : 1;
+        }
+
+        /**
+         * whether an element with key is present
+         */
+        bool contains(const Key &key) const {
+            return findNode(key, getHash(key)) != nullptr;
+        }
+
+        template<class K, transparentKey<K> = 0>
+        bool contains(const K &key) const {
+            return findNode(key, getHash(key)) != nullptr;
         }
 
         /**
@@ -742,45 +2491,270 @@ namespace sjtu {
          *   If no such element is found, past-the-end (see end()) iterator is returned.
          */
         iterator find(const Key &key) {
-            size_t keyHash = getHash(key);
-            size_t idx = keyHash % capacity;
+            return find_hashed(key, getHash(key));
+        }
+
+
+        const_iterator find(const Key &key) const {
+            return find_hashed(key, getHash(key));
+        }
+
+        /**
+         * find() with keyHash, the precomputed hash of key, for callers that
+         * hashed it already (say, to pick a shard); Hash is not called
+         */
+        iterator find_hashed(const Key &key, size_t keyHash) {
+            dataNode *dataPos = findNode(key, keyHash);
+            if (dataPos == nullptr)
+                return end();
+            touch(dataPos);
 
-            ptrNode *cur = (hashList[idx].head)->next;
+            iterator ret(dataPos, elemTable.head);
+            return ret;
+        }
+
+        const_iterator find_hashed(const Key &key, size_t keyHash) const {
+            dataNode *dataPos = findNode(key, keyHash);
+            if (dataPos == nullptr)
+                return cend();
 
-            while (cur != hashList[idx].tail) {
-                dataNode *dataPos = *(cur->val);
-                if (judgeEqual(key, (*(dataPos->val)).first)) {
-                    iterator ret(dataPos, elemTable.head);
-                    return ret;
+            const_iterator ret(dataPos, elemTable.head);
+            return ret;
+        }
+
+        /**
+         * finds keys[0 .. n) at once, storing the result for keys[i] in out[i].
+         * faster than n calls of find() once the map outgrows the cache,
+         * since the lookups overlap their memory accesses.
+         */
+        void find_batch(const Key *keys, size_t n, iterator *out) {
+            dataNode *found[batchWidth];
+            for (size_t base = 0; base < n; base += batchWidth) {
+                size_t width = n - base < batchWidth ? n - base : batchWidth;
+                probeBatch(keys + base, width, found);
+                for (size_t i = 0; i < width; i++) {
+                    if (found[i] == nullptr) {
+                        out[base + i] = end();
+                        continue;
+                    }
+                    touch(found[i]);
+                    out[base + i] = iterator(found[i], elemTable.head);
                 }
+            }
+        }
 
-                cur = cur->next;
+        void find_batch(const Key *keys, size_t n, const_iterator *out) const {
+            dataNode *found[batchWidth];
+            for (size_t base = 0; base < n; base += batchWidth) {
+                size_t width = n - base < batchWidth ? n - base : batchWidth;
+                probeBatch(keys + base, width, found);
+                for (size_t i = 0; i < width; i++)
+                    out[base + i] = found[i] == nullptr ? cend() : const_iterator(found[i], elemTable.head);
+            }
+        }
+
+        /**
+         * as find_batch, storing count(keys[i]) in out[i];
+         * returns how many of the keys are present
+         */
+        size_t count_batch(const Key *keys, size_t n, size_t *out) const {
+            dataNode *found[batchWidth];
+            size_t hits = 0;
+            for (size_t base = 0; base < n; base += batchWidth) {
+                size_t width = n - base < batchWidth ? n - base : batchWidth;
+                probeBatch(keys + base, width, found);
+                for (size_t i = 0; i < width; i++) {
+                    out[base + i] = found[i] == nullptr ? 0 : 1;
+                    hits += out[base + i];
+                }
             }
+            return hits;
+        }
 
-            return end();
+        /**
+         * count() with keyHash, the precomputed hash of key
+         */
+        size_t count_hashed(const Key &key, size_t keyHash) const {
+            return findNode(key, keyHash) == nullptr ? 0 : 1;
         }
 
+        /**
+         * as above for any key type the transparent Hash and Equal accept,
+         * e.g. a string_view or a C string against std::string keys;
+         * key is never converted to Key
+         */
+        template<class K, transparentKey<K> = 0>
+        iterator find(const K &key) {
+            dataNode *dataPos = findNode(key, getHash(key));
+            if (dataPos == nullptr)
+                return end();
+            touch(dataPos);
+            return iterator(dataPos, elemTable.head);
+        }
 
-        const_iterator find(const Key &key) const {
-            size_t keyHash = getHash(key);
-            size_t idx = keyHash % capacity;
+        template<class K, transparentKey<K> = 0>
+        const_iterator find(const K &key) const {
+            dataNode *dataPos = findNode(key, getHash(key));
+            if (dataPos == nullptr)
+                return cend();
+            return const_iterator(dataPos, elemTable.head);
+        }
 
-            ptrNode *cur = (hashList[idx].head)->next;
+        /**
+         * number of slots in the bucket table (the new one while an
+         * incremental rehash is still draining the old one)
+         */
+        size_t bucket_count() const {
+            return hashTable.capacity;
+        }
 
-            while (cur != hashList[idx].tail) {
-                dataNode *dataPos = *(cur->val);
-                if (judgeEqual(key, (*(dataPos->val)).first)) {
-                    const_iterator ret(dataPos, elemTable.head);
-                    return ret;
-                }
+        float load_factor() const {
+            if (hashTable.capacity == 0)
+                return 0;
+            return float(totLength) / hashTable.capacity;
+        }
 
-                cur = cur->next;
+        float max_load_factor() const {
+            return policy.grow_load;
+        }
+
+        /**
+         * sets the grow threshold, lowering the shrink threshold with it if
+         * the two would get too close, and grows the table right away if
+         * it is now fuller than allowed.
+         * throw runtime_error unless 0 < ml < 1.
+         */
+        void max_load_factor(float ml) {
+            resize_policy newPolicy = policy;
+            newPolicy.grow_load = ml;
+            if (newPolicy.shrink_load * 2 >= ml)
+                newPolicy.shrink_load = ml / 4;
+            checkPolicy(newPolicy);
+            policy = newPolicy;
+
+            if (totLength > policy.grow_load * hashTable.capacity)
+                rehash(0);
+        }
+
+        /**
+         * rebuilds the bucket table with at least count slots, and at least
+         * as many as size() needs, rounded up to a size the hash policy accepts.
+         * rehash(0) on an empty map releases the table.
+         */
+        void rehash(size_t count) {
+            size_t newCapacity = 0;
+            if (totLength != 0 || count != 0) {
+                newCapacity = bucketsFor(totLength);
+                if (newCapacity < count)
+                    newCapacity = indexPolicy::round_size(count);
+            }
+
+            if (oldTable.capacity != 0)
+                finishRehash();
+            if (newCapacity == hashTable.capacity)
+                return;
+            if (newCapacity == 0) {
+                hashTable.release(elemTable.alloc);
+                return;
             }
+            rehashTo(newCapacity);
+            finishRehash();
+        }
+
+        /**
+         * makes room for count elements, so inserting up to that many
+         * never resizes the table
+         */
+        void reserve(size_t count) {
+            size_t newCapacity = bucketsFor(count);
+            if (newCapacity > hashTable.capacity)
+                rehash(newCapacity);
+        }
+
+        /**
+         * allocates the storage of count more nodes (and the list sentinels)
+         * up front, so the next count insertions take their nodes without
+         * calling the allocator. erased nodes are reused either way; clear()
+         * hands all node storage back.
+         */
+        void reserve_nodes(size_t count) {
+            if (count == 0)
+                return;
+            if (elemTable.head == nullptr)
+                elemTable.initSentinels();
+            elemTable.pool.reserve(count, elemTable.alloc);
+        }
 
-            return cend();
+        const resize_policy &get_resize_policy() const {
+            return policy;
+        }
+
+        /**
+         * takes effect from the next insert or erase.
+         * throw runtime_error if the thresholds could make the table thrash or fill up.
+         */
+        void set_resize_policy(const resize_policy &resizePolicy) {
+            checkPolicy(resizePolicy);
+            policy = resizePolicy;
+        }
+
+        /**
+         * with step > 0 a resize no longer rebuilds the whole index at once:
+         * the old table stays alive next to the new one, lookups consult
+         * both, and every insert or erase drains at least step more slots
+         * of the old one. step == 0 (the default) rehashes everything in place.
+         * a slot costs a step whether it is empty or not, and so does every
+         * entry moved, so a drain after a grow takes about 1.5 / grow_load
+         * steps per insert (3 with the default policy) to end before the
+         * next grow; smaller steps are raised as far as that needs, larger
+         * ones end the drain sooner.
+         */
+        void set_incremental_rehash(size_t step) {
+            migrateStep = step;
+            if (step == 0 && oldTable.capacity != 0)
+                finishRehash();
+        }
+
+        /**
+         * in access order, every hit of find, find_hashed, find_batch, at,
+         * get_if, try_at, operator[], subscript_hashed and insert_or_assign
+         * moves its entry to the back, so begin() is the least recently used
+         * one. lookups through a const map never reorder. off by default.
+         */
+        void set_access_order(bool on) {
+            accessOrder = on;
+        }
+
+        bool access_order() const {
+            return accessOrder;
         }
     };
 
+    template<class Key, class T, class Hash, class Equal, class Allocator>
+    void swap(linked_hashmap<Key, T, Hash, Equal, Allocator> &lhs,
+              linked_hashmap<Key, T, Hash, Equal, Allocator> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+#ifdef SJTU_LINKEDHASHMAP_PMR
+    namespace pmr {
+        /**
+         * a linked_hashmap drawing all its memory from a std::pmr::memory_resource,
+         * e.g. sjtu::pmr::linked_hashmap<int, int> map(&monotonicResource);
+         * the nodes live in a few slabs per map, so with a monotonic resource and
+         * trivially destructible elements clear() and destruction do not visit them.
+         */
+        template<
+                class Key,
+                class T,
+                class Hash = std::hash<Key>,
+                class Equal = std::equal_to<Key>
+        >
+        using linked_hashmap = sjtu::linked_hashmap<Key, T, Hash, Equal,
+                std::pmr::polymorphic_allocator<pair<const Key, T> > >;
+    }
+#endif
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,343 @@
+/**
+ * a fixed-capacity least-recently-used cache on top of linked_hashmap
+ */
+#ifndef SJTU_LRU_CACHE_HPP
+#define SJTU_LRU_CACHE_HPP
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include "linked_hashmap.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+    /**
+     * keeps at most capacity() entries in a linked_hashmap run in access
+     * order, so its front is always the least recently used entry; a put()
+     * into a full cache evicts that one first.
+     * with a weigher set, entries are also evicted from the front until the
+     * total weight fits the budget, so the cache can bound bytes rather than
+     * entries.
+     * the bucket table and the storage of every node are allocated when the
+     * cache is built, and an evicted entry's node is reused by the next one,
+     * so a cache in steady state never calls the allocator itself.
+     */
+    template<
+            class Key,
+            class T,
+            class Hash = std::hash<Key>,
+            class Equal = std::equal_to<Key>,
+            class Allocator = std::allocator<pair<const Key, T> >
+    >
+    class lru_cache {
+    private:
+        /**
+         * a cached value and the weight charged for it when it was stored,
+         * which is what its removal refunds
+         */
+        struct entry {
+            T value;
+            size_t charged;
+
+            template<class M>
+            entry(M &&value, size_t charged) : value(std::forward<M>(value)), charged(charged) {}
+        };
+
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<pair<const Key, entry> > entryAllocator;
+        typedef linked_hashmap<Key, entry, Hash, Equal, entryAllocator> map_type;
+
+    public:
+        /**
+         * walks the entries as pairs of references to the key and the value
+         */
+        class const_iterator {
+        private:
+            friend class lru_cache;
+
+            typename map_type::const_iterator pos;
+
+            explicit const_iterator(const typename map_type::const_iterator &pos) : pos(pos) {}
+
+        public:
+            typedef pair<const Key &, const T &> reference;
+
+            /**
+             * keeps the pair operator-> points into alive for the expression
+             */
+            struct pointer {
+                reference ref;
+
+                const reference *operator->() const {
+                    return &ref;
+                }
+            };
+
+            const_iterator() {}
+
+            reference operator*() const {
+                return reference(pos->first, pos->second.value);
+            }
+
+            pointer operator->() const {
+                pointer ret = {**this};
+                return ret;
+            }
+
+            const_iterator &operator++() {
+                ++pos;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator ret = *this;
+                ++pos;
+                return ret;
+            }
+
+            const_iterator &operator--() {
+                --pos;
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                const_iterator ret = *this;
+                --pos;
+                return ret;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                return pos == rhs.pos;
+            }
+
+            bool operator!=(const const_iterator &rhs) const {
+                return pos != rhs.pos;
+            }
+        };
+
+        /**
+         * called with an entry just before it is evicted; it may move the
+         * value out. not called for erase() or clear().
+         */
+        typedef std::function<void(const Key &, T &)> eviction_callback;
+
+        /**
+         * the cost of an entry, e.g. its size in bytes. an entry is weighed
+         * when it is put() and keeps that weight until it leaves, so a value
+         * changed through get() is not weighed again: put() it again for that.
+         */
+        typedef std::function<size_t(const Key &, const T &)> weigher;
+
+    private:
+        map_type entries; //least recently used first
+        size_t cap;
+        eviction_callback onEvict;
+        weigher weigh;
+        size_t totalWeight, weightBudget;
+        size_t hitCount, missCount, evictCount;
+
+        /**
+         * each entry weighs 1 until a weigher is set
+         */
+        size_t measure(const Key &key, const T &value) const {
+            return weigh ? weigh(key, value) : 1;
+        }
+
+        void evictFront() {
+            typename map_type::iterator victim = entries.begin();
+            totalWeight -= victim->second.charged;
+            if (onEvict)
+                onEvict(victim->first, victim->second.value);
+            entries.erase(victim);
+            evictCount++;
+        }
+
+        /**
+         * evicts from the front until the weight fits the budget; the most
+         * recently used entry always stays, even if it alone is too heavy
+         */
+        void trim() {
+            while (totalWeight > weightBudget && entries.size() > 1)
+                evictFront();
+        }
+
+        /**
+         * charges the entry's current weight, refunding what it was charged before
+         */
+        void charge(const Key &key, entry &cached) {
+            totalWeight -= cached.charged;
+            cached.charged = measure(key, cached.value);
+            totalWeight += cached.charged;
+        }
+
+        template<class K, class M>
+        T &store(K &&key, M &&value) {
+            entry *found = entries.get_if(key);
+            if (found != nullptr) {
+                found->value = std::forward<M>(value);
+                charge(key, *found);
+                trim();
+                return found->value;
+            }
+            if (entries.size() == cap)
+                evictFront();
+            typename map_type::iterator pos = entries.try_emplace(std::forward<K>(key), std::forward<M>(value), 0).first;
+            charge(pos->first, pos->second);
+            trim();
+            return pos->second.value;
+        }
+
+        void preallocate() {
+            entries.reserve(cap);
+            entries.reserve_nodes(cap);
+        }
+
+    public:
+        /**
+         * throw runtime_error if capacity is 0
+         */
+        explicit lru_cache(size_t capacity, const Allocator &alloc = Allocator())
+                : entries(resize_policy(0.5f, 0.125f, 16, false), entryAllocator(alloc)), cap(capacity),
+                  totalWeight(0), weightBudget(capacity), hitCount(0), missCount(0), evictCount(0) {
+            if (capacity == 0)
+                throw runtime_error();
+            entries.set_access_order(true);
+            preallocate();
+        }
+
+        lru_cache(const lru_cache &) = delete;
+
+        lru_cache &operator=(const lru_cache &) = delete;
+
+        /**
+         * the value cached for key, now the most recently used, or nullptr
+         * on a miss; counts a hit or a miss
+         */
+        T *get(const Key &key) {
+            entry *found = entries.get_if(key);
+            if (found == nullptr) {
+                missCount++;
+                return nullptr;
+            }
+            hitCount++;
+            return &found->value;
+        }
+
+        /**
+         * the value cached for key without touching its recency or the counters
+         */
+        const T *peek(const Key &key) const {
+            const entry *found = static_cast<const map_type &>(entries).get_if(key);
+            return found == nullptr ? nullptr : &found->value;
+        }
+
+        bool contains(const Key &key) const {
+            return entries.contains(key);
+        }
+
+        /**
+         * caches value under key as the most recently used entry, replacing
+         * the old value if key is present; least recently used entries are
+         * evicted while the cache is full or over its weight budget
+         */
+        template<class M>
+        T &put(const Key &key, M &&value) {
+            return store(key, std::forward<M>(value));
+        }
+
+        template<class M>
+        T &put(Key &&key, M &&value) {
+            return store(std::move(key), std::forward<M>(value));
+        }
+
+        /**
+         * drops key if present, without calling the eviction callback
+         */
+        size_t erase(const Key &key) {
+            typename map_type::const_iterator pos = static_cast<const map_type &>(entries).find(key);
+            if (pos == entries.cend())
+                return 0;
+            totalWeight -= pos->second.charged;
+            entries.erase(typename map_type::iterator(pos));
+            return 1;
+        }
+
+        /**
+         * drops every entry; the counters are kept
+         */
+        void clear() {
+            entries.clear();
+            totalWeight = 0;
+            preallocate();
+        }
+
+        void set_eviction_callback(eviction_callback callback) {
+            onEvict = std::move(callback);
+        }
+
+        /**
+         * weighs every entry with callback from now on and keeps the total
+         * weight within budget, evicting right away if it is over
+         */
+        void set_weigher(weigher callback, size_t budget) {
+            weigh = std::move(callback);
+            weightBudget = budget;
+            for (typename map_type::iterator it = entries.begin(); it != entries.end(); ++it)
+                charge(it->first, it->second);
+            trim();
+        }
+
+        /**
+         * the total weight of the cached entries, size() without a weigher
+         */
+        size_t weight() const {
+            return totalWeight;
+        }
+
+        size_t budget() const {
+            return weightBudget;
+        }
+
+        size_t size() const {
+            return entries.size();
+        }
+
+        size_t capacity() const {
+            return cap;
+        }
+
+        bool empty() const {
+            return entries.empty();
+        }
+
+        size_t hits() const {
+            return hitCount;
+        }
+
+        size_t misses() const {
+            return missCount;
+        }
+
+        size_t evictions() const {
+            return evictCount;
+        }
+
+        void reset_stats() {
+            hitCount = missCount = evictCount = 0;
+        }
+
+        /**
+         * the entries from least to most recently used
+         */
+        const_iterator begin() const {
+            return const_iterator(entries.cbegin());
+        }
+
+        const_iterator end() const {
+            return const_iterator(entries.cend());
+        }
+    };
+
+}
+
+#endif